@@ -1,15 +1,14 @@
 #pragma once
 
+#include <cmath>
 #include <vector>
+#include <fgpg/grap_data.h>
 #include <fgpg/triangle_plane_data.h>
 #include <fgpg/fcl_utils.h>
+#include <fgpg/triangle_bvh.h>
 
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/point_xy.hpp>
-#include <boost/geometry/geometries/polygon.hpp>
 
-
-double getGraspDistance(const Eigen::Isometry3d& transform, const FCLGripper& gripper, const std::vector<TrianglePlaneData>& planes)
+inline double getGraspDistance(const Eigen::Isometry3d& transform, const FCLGripperBase& gripper, const std::vector<TrianglePlaneData>& planes)
 {
   auto n = gripper.getPalmNormalVector(transform);
   auto o = gripper.getPalmOrigin(transform);
@@ -37,41 +36,80 @@ double getGraspDistance(const Eigen::Isometry3d& transform, const FCLGripper& gr
   return min_distance;
 }
 
+/**
+ * @brief Palm distances (TriangleBVH::getPalmDistance) of many grasps by ray casting on a BVH, in parallel
+ * 
+ * @param distances (optional) distance of every grasp
+ * @return average distance
+ */
+inline double getAverageGraspDistance(const std::vector<Eigen::Isometry3d>& transforms, const FCLGripperBase& gripper, 
+                                      const TriangleBVH& bvh, std::vector<double>* distances = nullptr)
+{
+  const long num = transforms.size();
+  std::vector<double> dists (num);
+  double sum = 0.0;
+
+  #pragma omp parallel for schedule(dynamic, 64) reduction(+:sum)
+  for (long i = 0; i < num; i++)
+  {
+    dists[i] = bvh.getPalmDistance(gripper.getPalmOrigin(transforms[i]), gripper.getPalmNormalVector(transforms[i]));
+    sum += dists[i];
+  }
 
-// class GraspAreaCalculator
-// {
-// public:
-//   GraspAreaCalculator();
-//   double calcArea(const Eigen::Isometry3d & transform)
-//   {
-//     auto f1 = gripper_.getFinger1PlanePoints(transform);
-//     auto f2 = gripper_.getFinger2PlanePoints(transform);
-//     auto p = gripper_.getPalmPlanePoints(transform);
+  if (distances != nullptr)
+  {
+    distances->swap(dists);
+  }
+  return sum / num;
+}
+
+
+/**
+ * @brief Contact area of the finger pads of a closed grasp
+ * 
+ * A pad is the finger rectangle of getFinger1PlanePoints/getFinger2PlanePoints 
+ * ([-d, l - d] x [-y1l / 2, y1l / 2] in the hand frame) moved from z = +-h to the 
+ * contacts at z = +-half_width. The triangles near a pad (BVH box query) that face 
+ * it within the angle tolerance are clipped in the pad plane (Sutherland-Hodgman) 
+ * to the rectangle and to the band within the distance tolerance of the pad; the 
+ * area is the sum of the clipped polygons.
+ * 
+ * The clip buffers are members, so one calculator per thread and no allocation per grasp.
+ */
+class GraspAreaCalculator
+{
+public:
+  GraspAreaCalculator(const FCLGripperBase & gripper, const std::vector<TrianglePlaneData> & planes, const TriangleBVH & bvh);
 
-//     std::vector<Eigen::Matrix<double, 3, 5> > planes;
-//     planes.push_back(f1);
-//     planes.push_back(f2);
-//     planes.push_back(p);
+  /// @param angle clamped to [0, 1.5] rad, so the pad normal of a facing triangle stays out of the pad plane
+  void setTolerance(double distance, double angle);
 
-//     typedef boost::geometry::model::polygon<boost::geometry::model::d2::point_xy<double> > polygon;
-//     typedef boost::geometry::model::d2::point_xy<double> point_type;
+  /// @param areas contact area of finger 1 (+z) and finger 2 (-z)
+  void calcArea(const Eigen::Isometry3d & transform, double half_width, double areas[2]);
 
-//     for (auto & plane : planes)
-//     {
-//       Eigen::Vector3d normal = plane.col(4);
-//       Eigen::Vector3d v1 = plane.col(0) - plane.col(1);
-//       Eigen::Vector3d v2 = plane.col(0) - plane.col(2);
+private:
+  static const int kMaxVertices = 16; ///< a triangle clipped by six half-planes has at most 9
 
-//       polygon triangle_polygon, gripper_polygon;
-//       // triangle.outer().
+  /// @brief keeps a * x + b * y + c >= 0 of polygon_[current_], returns false if nothing is left
+  bool clip(double a, double b, double c);
+  double calcPadArea(const Eigen::Isometry3d & transform, double pad_z, double pad_normal_z);
 
-      
-//     }
+  const FCLGripperBase & gripper_;
+  const std::vector<TrianglePlaneData> & planes_;
+  const TriangleBVH & bvh_;
+  double distance_tolerance_ {1e-3};
+  double cos_angle_tolerance_ {std::cos(0.2)};
 
-//   }
-  
+  double polygon_[2][kMaxVertices][2]; ///< double buffer of (x, y) in the hand frame
+  int size_[2];
+  int current_ {0};
+};
 
-// private:
-//   TrianglePlaneData triangle_;
-//   const FCLGripper &gripper_;
-// };
\ No newline at end of file
+/**
+ * @brief Sets GraspData::contact_area of every grasp, in parallel
+ * 
+ * The grasps are closed at half of the distance of their two points.
+ */
+void computeContactAreas(std::vector<GraspData> & grasps, const FCLGripperBase & gripper, 
+                         const std::vector<TrianglePlaneData> & planes, const TriangleBVH & bvh,
+                         double distance_tolerance, double angle_tolerance);
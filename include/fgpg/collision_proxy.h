@@ -0,0 +1,79 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+
+#include "fgpg/spatial_hash.h"
+#include "fgpg/triangle_plane_data.h"
+
+/**
+ * @brief Conservative coarse proxy of a triangle mesh made of solid axis-aligned boxes
+ * 
+ * Every grid cell (size: resolution) touched by a triangle is occupied and consecutive
+ * occupied cells along x are merged into one box, so the boxes enclose the whole surface.
+ * A body which does not touch any box can not touch the original mesh.
+ */
+class CollisionProxy
+{
+public:
+  /**
+   * @param mesh triangles
+   * @param resolution cell size (m)
+   * @param margin the boxes are inflated by this distance (m)
+   */
+  void build(const std::vector<TrianglePlaneData> &mesh, double resolution, double margin);
+
+  /// @brief indices of the boxes overlapping the query box (cleared first)
+  void findBoxes(const Eigen::AlignedBox3d &query, std::vector<int> &box_ids) const;
+
+  const std::vector<Eigen::AlignedBox3d> & getBoxes() const { return boxes_; }
+  size_t getNumCells() const { return num_cells_; }
+
+private:
+  struct Run
+  {
+    int64_t x0, x1; ///< first and last occupied cell along x
+    int box_id;
+  };
+
+  double resolution_ {0.01};
+  double inverse_resolution_ {100.0};
+  size_t num_cells_ {0};
+
+  std::vector<Eigen::AlignedBox3d> boxes_;
+  std::unordered_map<SpatialHashKey, std::vector<Run>, SpatialHashKeyHasher> runs_; ///< key: (0, y, z)
+  Eigen::AlignedBox3d bound_;
+};
+
+/// @see Akenine-Moller, "Fast 3D Triangle-Box Overlap Testing"
+bool triangleBoxOverlap(const Eigen::Vector3d &center, const Eigen::Vector3d &half_size,
+                        const Eigen::Vector3d &a, const Eigen::Vector3d &b, const Eigen::Vector3d &c);
@@ -0,0 +1,77 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Eigen/Dense>
+
+#include "fgpg/grap_data.h"
+#include "fgpg/grasp_coverage_evaluator.h"
+#include "fgpg/triangle_plane_data.h"
+#include "fgpg/yaml_config.h"
+
+/// @brief (grasp center, approach direction) of every grasp, as GraspCoverageEvaluator takes them
+std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > getCoverageGraspPoints(const std::vector<GraspData> & grasps);
+
+/**
+ * @brief Sets the model, the grasps and the binning options of the config 
+ * (leaf_size, num_orientation_leaf, orientation_binning, coverage_histogram; 'both' is dense here)
+ */
+void setupCoverageEvaluator(const YAMLConfig & config, const std::vector<TrianglePlaneData> & triangles, 
+                            const std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > & grasp_data, 
+                            GraspCoverageEvaluator & gce);
+
+/**
+ * @brief getNumberOfBin and both entropies, printing the histogram memory and time
+ * 
+ * With coverage_histogram 'both' the sparse and then the dense backend are run and 
+ * reported, and a warning is printed unless their entropies are identical.
+ * 
+ * @param out where the report goes (e.g. a buffer per parallel task)
+ */
+void computeCoverageEntropy(const YAMLConfig & config, GraspCoverageEvaluator & gce, 
+                            double & full_entropy, double & pos_entropy, std::ostream & out = std::cout);
+
+/**
+ * @brief Prints GraspCoverageEvaluator::getMultiResolutionEntropy and writes it as CSV 
+ * (leaf_size, orientation_size, occupied_bins, pos_entropy, full_entropy) to file_name
+ */
+void writeEntropyCurve(const GraspCoverageEvaluator & gce, int num_levels, const std::string & file_name);
+
+/**
+ * @brief Computes GraspCoverageEvaluator::getBootstrapIntervals with the coverage_bootstrap_* 
+ * options and random_seed, and prints the intervals and the time
+ * 
+ * @param distances per grasp (e.g. palm distances), or empty
+ */
+CoverageBootstrap printBootstrapIntervals(const YAMLConfig & config, const GraspCoverageEvaluator & gce, 
+                                          const std::vector<double> & distances);
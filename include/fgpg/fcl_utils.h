@@ -47,12 +47,14 @@
 #include <fcl/distance.h>
 
 #include <fgpg/yaml_config.h>
+#include <fgpg/vertex_welding.h>
+#include <fgpg/collision_proxy.h>
 
 #include <ros/package.h>
+#include <chrono>
 #include <cmath>
-typedef fcl::OBBRSS BV;
-typedef fcl::BVHModel<BV> BVHM;
-typedef std::shared_ptr<BVHM> BVHMPtr;
+#include <string>
+#include <vector>
 using fcl::Box;
 typedef std::shared_ptr<fcl::Box> BoxPtr;
 using fcl::CollisionObject;
@@ -63,17 +65,79 @@ typedef pcl::PointXYZRGBNormal PointT;
 typedef std::shared_ptr<PointT> PointTPtr;
 
 using namespace pcl;
-struct FCLGripper
+
+/**
+ * @brief Name of the bounding volume type used in the config file (bv_type)
+ */
+template <typename BV> struct BVName;
+template <> struct BVName<fcl::AABB> { static std::string get() { return "AABB"; } };
+template <> struct BVName<fcl::OBB> { static std::string get() { return "OBB"; } };
+template <> struct BVName<fcl::RSS> { static std::string get() { return "RSS"; } };
+template <> struct BVName<fcl::kIOS> { static std::string get() { return "kIOS"; } };
+template <> struct BVName<fcl::OBBRSS> { static std::string get() { return "OBBRSS"; } };
+
+/**
+ * @brief Build a BVH model from the welded, vertex-indexed mesh
+ * 
+ * Triangles which degenerate after welding are skipped.
+ * The build time and the memory usage of the model are reported with the given name.
+ */
+template <typename BV>
+std::shared_ptr<fcl::BVHModel<BV> > buildBVHModel(const std::vector<TrianglePlaneData> &mesh,
+                                                  double weld_tolerance, const std::string &name)
+{
+  auto begin = std::chrono::steady_clock::now();
+
+  std::vector<Eigen::Vector3d> vertices;
+  std::vector<Eigen::Vector3i> indices;
+  weldVertices(mesh, weld_tolerance, vertices, indices);
+
+  std::vector<fcl::Vec3f> points;
+  std::vector<fcl::Triangle> triangles;
+  points.reserve(vertices.size());
+  triangles.reserve(indices.size());
+
+  for (const auto &vertex : vertices)
+  {
+    points.push_back(fcl::Vec3f(vertex(0), vertex(1), vertex(2)));
+  }
+  for (const auto &index : indices)
+  {
+    if (isDegenerate(index)) continue;
+    triangles.push_back(fcl::Triangle(index(0), index(1), index(2)));
+  }
+
+  auto model = std::make_shared<fcl::BVHModel<BV> >();
+  model->beginModel(triangles.size(), points.size());
+  model->addSubModel(points, triangles);
+  model->endModel();
+
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "[BVH] " << name << " (" << BVName<BV>::get() << "): "
+            << triangles.size() << " triangles, "
+            << mesh.size() * 3 << " -> " << points.size() << " vertices, "
+            << "build: " << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms, "
+            << "memory: " << model->memUsage(0) / 1024.0 << " KiB" << std::endl;
+
+  return model;
+}
+
+/**
+ * @brief Gripper geometry which does not depend on the bounding volume type
+ */
+struct FCLGripperBase
 {
   // BoxPtr g[4];
   // Eigen::Isometry3d t[4];
 
-  BVHMPtr g[3];
   Eigen::Isometry3d t[3];
   pcl::PolygonMesh mesh[3];
+  std::vector<TrianglePlaneData> triangles[3]; ///< 0: base, 1: left tip, 2: right tip
+  Eigen::AlignedBox3d part_box[3]; ///< bounding box of each part in its own frame
 
   double DXL_RAD = 13.5 * M_PI / 180 ;
   Eigen::Isometry3d T_DXL_CTR;
+  double open_half_width = 0.05; ///< finger offset of the fully opened hand model
 
   /// d: depth of the gripper
   /// h: width of the gripper
@@ -83,7 +147,7 @@ struct FCLGripper
   /// z2l: size of gripper finger (width)
   /// x4l: size of bar of the gripper (length)
   /// z4l: size of bar of the gripper (width)
-  double l, h, d, x1l, y1l, z2l, x4l, z4l;
+  double l {0.0}, h {0.0}, d {0.0}, x1l {0.0}, y1l {0.0}, z2l {0.0}, x4l {0.0}, z4l {0.0};
 
   void setParams(const YAMLConfig &config_)
   {
@@ -91,6 +155,12 @@ struct FCLGripper
     l =config_.gripper_params[2];
     h = config_.gripper_params[1];
     d = config_.gripper_params[0];
+    if (config_.gripper_params.size() >= 6)
+    {
+      x1l = config_.gripper_params[3];
+      y1l = config_.gripper_params[4];
+      z2l = config_.gripper_params[5];
+    }
     makeRealModel(config_);
 
   }
@@ -120,25 +190,24 @@ struct FCLGripper
   {
     const std::string & path = config.hand_model_path;
     pcl::io::loadPolygonFile(path + "/mesh/gripper_base.stl", mesh[0]);
-    std::vector<TrianglePlaneData> triangles0 = buildTriangleData(mesh[0]);
+    triangles[0] = buildTriangleData(mesh[0]);
 
     pcl::io::loadPolygonFile(path + "/mesh/gripper_tip_left.stl", mesh[1]);
-    std::vector<TrianglePlaneData> triangles1 = buildTriangleData(mesh[1]);
+    triangles[1] = buildTriangleData(mesh[1]);
 
     pcl::io::loadPolygonFile(path + "/mesh/gripper_tip_right.stl", mesh[2]);
-    std::vector<TrianglePlaneData> triangles2 = buildTriangleData(mesh[2]);
+    triangles[2] = buildTriangleData(mesh[2]);
 
     for (int i = 0; i < 3; i++)
       mTomm(mesh[i]);
 
-    g[0] = std::make_shared<BVHM>();
-    g[0] = loadMesh(triangles0);
-
-    g[1] = std::make_shared<BVHM>();
-    g[1] = loadMesh(triangles1);
-
-    g[2] = std::make_shared<BVHM>();
-    g[2] = loadMesh(triangles2);
+    for (int i = 0; i < 3; i++)
+    {
+      part_box[i].setEmpty();
+      for (const auto & triangle : triangles[i])
+        for (const auto & point : triangle.points)
+          part_box[i].extend(point);
+    }
       
     T_DXL_CTR.linear() << cos(DXL_RAD), 0,  -sin(DXL_RAD),
                              0,        1.0,  0,
@@ -160,53 +229,42 @@ struct FCLGripper
 
 
     // left
-    Eigen::Isometry3d finger_frame1, finger_frame2;
-    finger_frame1.setIdentity();
-    finger_frame2.setIdentity();
-    finger_frame1.translation() = Eigen::Vector3d(0.05, -0.0745, 0.0);
-    t[1] = t[0] * finger_frame1;
+    t[1] = getFingerTransform(1, open_half_width);
     // right
-    finger_frame2.translation() = Eigen::Vector3d(-0.05, -0.0745, 0.0);
-    t[2] = t[0] * finger_frame2;
+    t[2] = getFingerTransform(2, open_half_width);
 
     std::cout << "***********" << std::endl;
   }
 
-  BVHMPtr loadMesh(const std::vector<TrianglePlaneData> &mesh)
+  /**
+   * @brief Axis-aligned bounding box of a part in the world frame
+   */
+  Eigen::AlignedBox3d getPartBox(int i, const Eigen::Isometry3d &part_transform) const
   {
-    std::vector<fcl::Vec3f> points;
-    std::vector<fcl::Triangle> triangles;
-    BVHMPtr mesh_model_ = std::make_shared<BVHM>();
-
-    for (const auto &tri_plane : mesh)
+    Eigen::AlignedBox3d box;
+    box.setEmpty();
+    for (int c = 0; c < 8; c++)
     {
-      fcl::Triangle tri;
-
-      for (int i = 0; i < 3; i++)
-      {
-        tri[i] = points.size();
-        points.push_back(
-            fcl::Vec3f(
-                tri_plane.points[i](0) ,
-                tri_plane.points[i](1) ,
-                tri_plane.points[i](2) ));
-      }
-      triangles.push_back(tri);
+      box.extend(part_transform * part_box[i].corner(static_cast<Eigen::AlignedBox3d::CornerType>(c)));
     }
-    mesh_model_->beginModel();
-    mesh_model_->addSubModel(points, triangles);
-    mesh_model_->endModel();
-    
-    return mesh_model_;
+    return box;
   }
 
-  void changeWidth(double new_h)
+  /**
+   * @brief Transform of a finger (1: left, 2: right) opened by half_width, relative to the hand
+   */
+  Eigen::Isometry3d getFingerTransform(int i, double half_width) const
   {
-    t[1].linear().setIdentity();
-    t[1].translation() << -d + l / 2, 0, new_h + z2l / 2;
+    Eigen::Isometry3d finger_frame;
+    finger_frame.setIdentity();
+    finger_frame.translation() = Eigen::Vector3d(i == 1 ? half_width : -half_width, -0.0745, 0.0);
+    return t[0] * finger_frame;
+  }
 
-    t[2].linear().setIdentity();
-    t[2].translation() << -d + l / 2, 0, -new_h - z2l / 2;
+  void changeWidth(double new_h)
+  {
+    t[1] = getFingerTransform(1, new_h);
+    t[2] = getFingerTransform(2, new_h);
   }
 
   void drawGripper(pcl::visualization::PCLVisualizer &vis,
@@ -320,40 +378,170 @@ struct FCLGripper
   }
 };
 
-class CollisionCheck
+/**
+ * @brief Gripper geometry with collision models built on the bounding volume type BV
+ */
+template <typename BV>
+struct FCLGripperT : public FCLGripperBase
+{
+  typedef fcl::BVHModel<BV> BVHM;
+  typedef std::shared_ptr<BVHM> BVHMPtr;
+
+  BVHMPtr g[3];
+
+  void setParams(const YAMLConfig &config_)
+  {
+    FCLGripperBase::setParams(config_);
+
+    const char * part_names[3] = {"gripper_base", "gripper_tip_left", "gripper_tip_right"};
+    for (int i = 0; i < 3; i++)
+      g[i] = buildBVHModel<BV>(triangles[i], config_.weld_tolerance, part_names[i]);
+  }
+};
+
+typedef FCLGripperT<fcl::OBBRSS> FCLGripper;
+
+/**
+ * @brief Interface of the collision checker so that the bounding volume type can be chosen at runtime
+ */
+class CollisionCheckBase
+{
+public:
+  virtual ~CollisionCheckBase() {}
+
+  virtual void setConfig(const YAMLConfig &config) = 0;
+  virtual void loadMesh(const std::vector<TrianglePlaneData> &mesh) = 0;
+  virtual bool isFeasible(Eigen::Isometry3d gripper_transform, double distance) = 0;
+  virtual double getClearance(const Eigen::Isometry3d &gripper_transform, double upper_bound) = 0;
+  virtual double getMaxFeasibleWidth(const Eigen::Isometry3d &gripper_transform, 
+                                     const std::vector<double> &half_widths) = 0;
+
+  virtual FCLGripperBase & getGripperModel() = 0;
+  virtual std::string getBVName() const = 0;
+
+  bool verbose_ {true}; ///< print the colliding part and its transform
+
+  size_t proxy_accepted_ {0}; ///< queries accepted as collision-free by the proxy
+  size_t proxy_refined_ {0}; ///< queries checked again with the full mesh
+};
+typedef std::shared_ptr<CollisionCheckBase> CollisionCheckBasePtr;
+
+template <typename BV>
+class CollisionCheckT : public CollisionCheckBase
 {
 public:
+  typedef fcl::BVHModel<BV> BVHM;
+  typedef std::shared_ptr<BVHM> BVHMPtr;
+
   BVHMPtr mesh_model_;
-  FCLGripper gripper_model_;
+  FCLGripperT<BV> gripper_model_;
+  double weld_tolerance_ {1e-6};
+
+  bool use_proxy_ {false};
+  double proxy_resolution_ {0.01};
+  CollisionProxy proxy_;
+  std::vector<std::shared_ptr<fcl::Box> > proxy_boxes_;
+  std::vector<fcl::Transform3f> proxy_box_transforms_;
+  std::vector<int> proxy_box_ids_; ///< query buffer
+
+  void setConfig(const YAMLConfig &config) override
+  {
+    weld_tolerance_ = config.weld_tolerance;
+    use_proxy_ = config.use_proxy_collision;
+    proxy_resolution_ = config.proxy_resolution;
+    gripper_model_.setParams(config);
+  }
 
-  void loadMesh(const std::vector<TrianglePlaneData> &mesh)
+  FCLGripperBase & getGripperModel() override
   {
-    std::vector<fcl::Vec3f> points;
-    std::vector<fcl::Triangle> triangles;
-    mesh_model_ = std::make_shared<BVHM>();
+    return gripper_model_;
+  }
+
+  std::string getBVName() const override
+  {
+    return BVName<BV>::get();
+  }
 
-    for (const auto &tri_plane : mesh)
+  void loadMesh(const std::vector<TrianglePlaneData> &mesh) override
+  {
+    mesh_model_ = buildBVHModel<BV>(mesh, weld_tolerance_, "object");
+
+    if (use_proxy_)
     {
-      fcl::Triangle tri;
+      buildProxy(mesh);
+    }
+  }
 
-      for (int i = 0; i < 3; i++)
-      {
-        tri[i] = points.size();
-        points.push_back(
-            fcl::Vec3f(
-                tri_plane.points[i](0),
-                tri_plane.points[i](1),
-                tri_plane.points[i](2)));
-      }
-      triangles.push_back(tri);
+  void buildProxy(const std::vector<TrianglePlaneData> &mesh)
+  {
+    auto begin = std::chrono::steady_clock::now();
+    proxy_.build(mesh, proxy_resolution_, weld_tolerance_);
+
+    proxy_boxes_.clear();
+    proxy_box_transforms_.clear();
+    for (const auto & box : proxy_.getBoxes())
+    {
+      Eigen::Vector3d size = box.sizes();
+      Eigen::Vector3d center = box.center();
+      proxy_boxes_.push_back(std::make_shared<fcl::Box>(size(0), size(1), size(2)));
+
+      Eigen::Isometry3d box_transform;
+      box_transform.setIdentity();
+      box_transform.translation() = center;
+      fcl::Transform3f fcl_transform;
+      FCLEigenUtils::convertTransform(box_transform, fcl_transform);
+      proxy_box_transforms_.push_back(fcl_transform);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "[Proxy] resolution: " << proxy_resolution_ << " m, "
+              << mesh.size() << " triangles -> " << proxy_.getNumCells() << " cells, "
+              << proxy_boxes_.size() << " boxes, "
+              << "build: " << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+  }
+
+  /**
+   * @brief Check a gripper part against the proxy boxes overlapping its bounding box
+   */
+  bool collideProxy(int i, const Eigen::Isometry3d &part_transform)
+  {
+    proxy_.findBoxes(gripper_model_.getPartBox(i, part_transform), proxy_box_ids_);
+    if (proxy_box_ids_.empty())
+      return false;
+
+    fcl::Transform3f fcl_transform;
+    FCLEigenUtils::convertTransform(part_transform, fcl_transform);
+
+    fcl::CollisionRequest request;
+    for (int id : proxy_box_ids_)
+    {
+      fcl::CollisionResult result;
+      fcl::collide(proxy_boxes_[id].get(), proxy_box_transforms_[id], gripper_model_.g[i].get(), fcl_transform,
+                   request, result);
+      if (result.isCollision())
+        return true;
     }
-    mesh_model_->beginModel();
-    mesh_model_->addSubModel(points, triangles);
-    mesh_model_->endModel();
+    return false;
   }
 
-  bool isFeasible(Eigen::Isometry3d gripper_transform, double distance)
+  bool isFeasible(Eigen::Isometry3d gripper_transform, double distance) override
   {
+    // the proxy encloses the mesh, so only the proxy collisions are ambiguous
+    if (use_proxy_)
+    {
+      bool proxy_collided = false;
+      for (int i = 0; i < 2 && !proxy_collided; ++i)
+      {
+        proxy_collided = collideProxy(i, gripper_transform * gripper_model_.t[i]);
+      }
+      if (!proxy_collided)
+      {
+        proxy_accepted_++;
+        return true;
+      }
+      proxy_refined_++;
+    }
+
     // set the collision request structure, here we just use the default setting
     fcl::CollisionRequest request;
     // result will be returned via the collision result structure
@@ -372,8 +560,11 @@ public:
                    request, result[i]);      
       if (result[i].isCollision() == true)
       { 
-        std::cout << "Collision in " << i << std::endl;
-        std::cout << cur_transform.matrix() << std::endl;
+        if (verbose_)
+        {
+          std::cout << "Collision in " << i << std::endl;
+          std::cout << cur_transform.matrix() << std::endl;
+        }
         is_collided = true;
         // break;
       }
@@ -382,4 +573,106 @@ public:
     return !is_collided;
     // return true;
   }
-};
\ No newline at end of file
+
+  /**
+   * @brief Minimum distance between the object and the gripper parts, clipped at upper_bound
+   * 
+   * The result is seeded with the bound so that the traversal prunes every BV pair farther 
+   * than the current minimum; when nothing closer exists the bound is returned.
+   */
+  double getClearance(const Eigen::Isometry3d &gripper_transform, double upper_bound) override
+  {
+    fcl::DistanceRequest request;
+    fcl::Transform3f init;
+    init.setIdentity();
+
+    double clearance = upper_bound;
+    for (int i = 0; i < 2 ; ++i)
+    {
+      Eigen::Isometry3d cur_transform = gripper_transform * gripper_model_.t[i];
+      fcl::Transform3f fcl_transform;
+      FCLEigenUtils::convertTransform(cur_transform, fcl_transform);
+
+      fcl::DistanceResult result;
+      result.min_distance = clearance;
+      fcl::distance(mesh_model_.get(), init, gripper_model_.g[i].get(), fcl_transform,
+                    request, result);
+      clearance = std::min(clearance, result.min_distance);
+    }
+
+    return clearance;
+  }
+
+  /**
+   * @brief Check a single part, through the proxy first when it is enabled
+   */
+  bool collidePart(int i, const Eigen::Isometry3d &part_transform)
+  {
+    if (use_proxy_ && !collideProxy(i, part_transform))
+      return false;
+
+    fcl::CollisionRequest request;
+    fcl::CollisionResult result;
+    fcl::Transform3f init;
+    init.setIdentity();
+
+    fcl::Transform3f fcl_transform;
+    FCLEigenUtils::convertTransform(part_transform, fcl_transform);
+    fcl::collide(mesh_model_.get(), init, gripper_model_.g[i].get(), fcl_transform,
+                 request, result);
+    return result.isCollision();
+  }
+
+  /**
+   * @brief Widest collision-free finger opening among the candidates
+   * 
+   * The base does not move with the fingers, so it is checked once for all the openings.
+   * 
+   * @param half_widths finger offsets from the hand center, in descending order
+   * @return the first collision-free half width, or -1 if there is none
+   */
+  double getMaxFeasibleWidth(const Eigen::Isometry3d &gripper_transform, 
+                             const std::vector<double> &half_widths) override
+  {
+    if (collidePart(0, gripper_transform * gripper_model_.t[0]))
+      return -1.0;
+
+    for (double half_width : half_widths)
+    {
+      // the same parts as isFeasible
+      bool collided = false;
+      for (int i = 1; i < 2 && !collided; ++i)
+      {
+        collided = collidePart(i, gripper_transform * gripper_model_.getFingerTransform(i, half_width));
+      }
+      if (!collided)
+        return half_width;
+    }
+    return -1.0;
+  }
+};
+
+typedef CollisionCheckT<fcl::OBBRSS> CollisionCheck;
+
+/**
+ * @brief Bounding volume types selectable with bv_type (besides 'auto')
+ */
+inline const std::vector<std::string> & getBVTypeNames()
+{
+  static const std::vector<std::string> names {"AABB", "OBB", "RSS", "kIOS", "OBBRSS"};
+  return names;
+}
+
+/**
+ * @brief Instantiate the collision checker for the given bounding volume type
+ * @return nullptr if the name is not one of getBVTypeNames()
+ */
+inline CollisionCheckBasePtr makeCollisionCheck(const std::string &bv_type)
+{
+  if (bv_type == "AABB") return std::make_shared<CollisionCheckT<fcl::AABB> >();
+  if (bv_type == "OBB") return std::make_shared<CollisionCheckT<fcl::OBB> >();
+  if (bv_type == "RSS") return std::make_shared<CollisionCheckT<fcl::RSS> >();
+  if (bv_type == "kIOS") return std::make_shared<CollisionCheckT<fcl::kIOS> >();
+  if (bv_type == "OBBRSS") return std::make_shared<CollisionCheckT<fcl::OBBRSS> >();
+  return nullptr;
+}
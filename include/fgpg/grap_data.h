@@ -36,9 +36,15 @@
 struct GraspData
 {
   std::vector<Eigen::Vector3d> points;
+  std::vector<Eigen::Vector3d> normals; ///< outward surface normals at points
   Eigen::Isometry3d hand_transform;
   bool collision_data[100] = {false};
   bool available {false};
+  bool checked {false}; ///< available is already set by collisionCheck
+  double clearance {0.0}; ///< minimum gripper-object distance (only with compute_clearance)
+  double width {0.0}; ///< widest feasible finger opening (only with multi_width_evaluation)
+  double quality {0.0}; ///< antipodal quality in [0, 1] (only with compute_grasp_quality)
+  double contact_area[2] = {0.0, 0.0}; ///< finger pad contact areas, m^2 (only with compute_contact_area)
   
   GraspData()
   {
@@ -56,7 +62,7 @@ struct GraspData
     
     return out;
   }
-  double getDist()
+  double getDist() const
   {
     return (points[0] - points[1]).norm();
   }
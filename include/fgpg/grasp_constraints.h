@@ -0,0 +1,73 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+
+/**
+ * @brief Cheap geometric condition on the hand pose (see grasp_constraints in options.yaml)
+ * 
+ * The approach direction is the X axis of the hand frame, the grasp center its origin.
+ */
+struct GraspConstraint
+{
+  enum Type { TABLE, APPROACH_CONE, WORKSPACE_BOX };
+
+  Type type {TABLE};
+  std::string name;
+
+  Eigen::Vector3d axis {Eigen::Vector3d::UnitZ()}; ///< table: up direction, approach_cone: cone axis
+  double height {0.0}; ///< table: height of the table along axis (m)
+  double margin {0.0}; ///< table: minimum height of the grasp center over the table (m)
+  double half_angle {M_PI}; ///< approach_cone: (rad)
+  Eigen::Vector3d min_point {Eigen::Vector3d::Zero()}; ///< workspace_box: (m)
+  Eigen::Vector3d max_point {Eigen::Vector3d::Zero()}; ///< workspace_box: (m)
+
+  bool accepts(const Eigen::Isometry3d &hand_transform) const;
+
+  /**
+   * @brief Conservative test before the hand pose is known
+   * 
+   * @param center_begin, center_end segment that contains the grasp center
+   * @param approach_directions possible approach directions
+   * @return false only if no pose with these bounds is accepted
+   */
+  bool mayAccept(const Eigen::Vector3d &center_begin, const Eigen::Vector3d &center_end,
+                 const std::vector<Eigen::Vector3d> &approach_directions) const;
+};
+
+/// @return index of the first constraint that rejects the pose, -1 if all accept it
+int findViolatedConstraint(const std::vector<GraspConstraint> &constraints, const Eigen::Isometry3d &hand_transform);
+
+/// @return index of the first constraint that rejects every pose within the bounds, -1 if none
+int findViolatedConstraint(const std::vector<GraspConstraint> &constraints, 
+                           const Eigen::Vector3d &center_begin, const Eigen::Vector3d &center_end,
+                           const std::vector<Eigen::Vector3d> &approach_directions);
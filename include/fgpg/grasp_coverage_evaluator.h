@@ -26,6 +26,8 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#pragma once
+
 #include <iostream>
 #include <vector>
 #include <limits>
@@ -33,10 +35,42 @@
 #include <Eigen/Dense>
 #include <unsupported/Eigen/CXX11/Tensor>
 
+#include "fgpg/icosphere_binning.h"
+#include "fgpg/sparse_histogram.h"
 #include "fgpg/triangle_plane_data.h"
 
 typedef Eigen::Array<size_t, 3, 1> Array3size_t;
 
+/**
+ * @brief Entropies at one resolution of GraspCoverageEvaluator::getMultiResolutionEntropy
+ */
+struct CoverageLevel
+{
+  double leaf_size;
+  int orientation_size; ///< per component, or the number of icosphere cells
+  double pos_entropy;
+  double full_entropy;
+  size_t occupied_bins; ///< full bins
+};
+
+/// @brief Estimate and percentile bootstrap interval
+struct BootstrapInterval
+{
+  double estimate {0.0}; ///< value of the original sample
+  double lower {0.0};
+  double upper {0.0};
+};
+
+/// @brief Result of GraspCoverageEvaluator::getBootstrapIntervals
+struct CoverageBootstrap
+{
+  BootstrapInterval full_entropy;
+  BootstrapInterval pos_entropy;
+  BootstrapInterval average_distance; ///< only with distances
+  int num_resamples {0};
+  double confidence {0.0};
+};
+
 class GraspCoverageEvaluator
 {
 public:
@@ -47,16 +81,78 @@ public:
   void setModel(const std::vector<Eigen::Vector3d> & mesh_points);
 
   void setGraspPoints(const std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > & grasp_data);
+  /// @brief bins more grasps into the histograms (call getNumberOfBin first)
+  void addGraspPoints(const std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > & grasp_data);
+
+  /**
+   * @brief Incremental update of the histograms (call getNumberOfBin first)
+   * 
+   * Only the counts change, so a later getNumberOfBin re-bins the grasps of 
+   * setGraspPoints/addGraspPoints only. removeGrasp takes a grasp that was added.
+   */
+  void addGrasp(const Eigen::Vector3d & point, const Eigen::Vector3d & approach);
+  void removeGrasp(const Eigen::Vector3d & point, const Eigen::Vector3d & approach);
 
   void getMinMax3D();
   void getNumberOfBin();
 
   void setLeafSize(double leaf_size, int orientation_size);
+  /// @brief sparse: hash only the occupied bins instead of the dense tensors (call before getNumberOfBin)
+  void setSparseHistogram(bool sparse);
+  /**
+   * @brief Bin approach directions by the cells of an icosphere (20 * 4^subdivision cells)
+   * instead of quantizing each component to orientation_size (orientation_size^3 cells)
+   * 
+   * @param subdivision negative: component quantization
+   */
+  void setIcosphereBinning(int subdivision);
+  /// @brief bytes used by the histograms
+  size_t getHistogramMemory() const;
 
   double getFullEntropy();
   double getPosEntropy();
 
+  /// @brief O(1) entropies from the running sums of c log c (equal to the sweeps up to rounding)
+  double getRunningFullEntropy() const;
+  double getRunningPosEntropy() const;
+
+  /**
+   * @brief Entropies of the grasps of setGraspPoints at leaf_size * 2^k (k < num_levels), 
+   * each with orientation_size / 2^j for every j that divides it evenly (or every 
+   * coarser icosphere subdivision)
+   * 
+   * The grasps are binned once at the finest resolution; a coarser level merges 
+   * the occupied bins of the finer one. Positions use the nested lattice 
+   * floor(p / leaf_size), so a coarser position bin is the floor of the finer 
+   * one / 2. This is the lattice of getNumberOfBin, except that getNumberOfBin 
+   * truncates after shifting by min_bin: along an axis where the mesh reaches 
+   * negative coordinates its first bin also holds the cell below, so there the 
+   * entropies differ from setLeafSize + getNumberOfBin (more at coarse levels).
+   */
+  std::vector<CoverageLevel> getMultiResolutionEntropy(int num_levels) const;
+
+  /**
+   * @brief Percentile bootstrap intervals of the entropies of the grasps of setGraspPoints
+   * (and of the average of distances) in the bins of getNumberOfBin, which must be called first
+   * 
+   * Every grasp is binned once into a compact bin id; a resample only draws grasp 
+   * indices and counts their ids. The draws come from counterUniform, so the 
+   * intervals depend on seed only, not on the number of threads.
+   * 
+   * @param confidence in (0, 1]; 0.95 (with a warning) otherwise
+   * @param distances per grasp in the order of setGraspPoints (e.g. palm distances), or empty
+   */
+  CoverageBootstrap getBootstrapIntervals(int num_resamples, double confidence, std::uint64_t seed, 
+                                          const std::vector<double> & distances = std::vector<double>()) const;
+  int getNumGrasps() const { return total_num_points_; }
+
 private:
+  void addToBin(const std::pair<Eigen::Vector3d, Eigen::Vector3d> & data, int delta = 1);
+  double getRunningEntropy(double sum_clogc) const;
+  Eigen::Vector3i getOrientationBin(const Eigen::Vector3d & approach) const;
+  static Eigen::Vector3i getPositionBin(const Eigen::Vector3d & pt, double inverse_leaf_size, const Eigen::Vector3i & min_bin);
+  double getEntropy(const SparseHistogram & histogram) const;
+
   std::vector<Eigen::Vector3d> mesh_points_;
   std::vector<std::pair<Eigen::Vector3d, Eigen::Vector3d> > grasp_data_;
   Eigen::Array3d min_point_;
@@ -67,9 +163,19 @@ private:
   Eigen::Tensor<int, 6> num_points_tensor_full_;
   Eigen::Tensor<int, 3> num_points_tensor_pos_;
 
+  bool sparse_ {false};
+  SparseHistogram num_points_hash_full_; ///< key: index of the bin in the order of the dense loops
+  SparseHistogram num_points_hash_pos_;
+
   double leaf_size_ {0.05}; // Cube shaped voxel (x=y=z)
   double inverse_leaf_size_ {20};
   int orientation_size_ {3};
+  int icosphere_subdivision_ {-1};
+  IcosphereBinning icosphere_;
+  Eigen::Vector3i orientation_dims_ {3, 3, 3}; ///< size of the three orientation dimensions
 
+  bool binned_ {false}; ///< getNumberOfBin has set min_bin_
   int total_num_points_ {1};
+  double sum_clogc_full_ {0.0}; ///< sum of c log c over the full bins
+  double sum_clogc_pos_ {0.0};
 };
\ No newline at end of file
@@ -47,12 +47,27 @@
 #include "fgpg/mesh_sampling.h"
 #include "fgpg/yaml_config.h"
 #include "fgpg/calc_area.h"
+#include "fgpg/grasp_coverage_evaluator.h"
+#include "fgpg/coverage_utils.h"
+#include "fgpg/grasp_quality.h"
+#include "fgpg/planar_region.h"
+#include "fgpg/spatial_hash.h"
+#include "fgpg/symmetry_detection.h"
 
 typedef std::pair<Eigen::Vector3d, Eigen::Vector3d> Line;
 
 class GraspPointGenerator
 {
 public:
+  /// @brief how much of the mesh the anytime mode got through
+  struct AnytimeReport
+  {
+    double elapsed_ms {0.0};
+    double covered {0.0};
+    double total {0.0};
+    std::string unit;
+  };
+
   // Static functions
   static Eigen::Vector3d PCL2eigen(const PointT &pcl);
   static Eigen::Vector3d PCLNormal2eigen(const PointT &pcl);
@@ -62,6 +77,9 @@ public:
 
   const std::vector <TrianglePlaneData> & getTrianglePlaneData();
   const std::vector <GraspData> & getGraspData();
+  /// @brief candidates before the collision check
+  size_t getNumCandidates() const;
+  const AnytimeReport & getAnytimeReport();
 
   void setConfig(const YAMLConfig &config);
   void setMesh(const std::vector <TrianglePlaneData> triangle_mesh);
@@ -75,34 +93,75 @@ public:
   void saveGraspCandidates(std::ofstream &of);
   void saveContGraspCandidates(std::ofstream &of);
 
-  double getAverageDistance();
+  /// @param distances (optional) palm distance of every grasp of getGraspData
+  double getAverageDistance(std::vector<double>* distances = nullptr);
 
 private:
-  CollisionCheck collision_check_;
+  CollisionCheckBasePtr collision_check_;
 
   std::vector <GraspData> grasps_;  ///< All generated grasp pose candidates
   std::vector <GraspData> grasp_cand_collision_free_;
   std::vector <GraspData> grasp_cand_in_collision_;
+  AnytimeReport anytime_report_;
+  std::vector<size_t> constraint_prechecked_; ///< per constraint, rejected before findPair
+  std::vector<size_t> constraint_rejected_; ///< per constraint, rejected before the collision check
+  size_t num_classified_ {0}; ///< grasps_ before this index went through collisionCheck()
 
   std::vector <ContGraspPose> continuous_grasp_pose_;
   std::vector <ContGraspPose> continuous_grasp_pose_simplified_;
 
   std::vector <TrianglePlaneData> planes_;
+  std::vector <PlanarRegion> regions_;
+  HalfEdgeMesh half_edge_mesh_;
+  SymmetryGroup symmetry_;
+  std::vector<bool> face_in_region_; ///< face lies in the fundamental region of symmetry_
 
   pcl::PointCloud<pcl::PointXYZRGBNormal>::Ptr candid_sample_cloud_ {new pcl::PointCloud<pcl::PointXYZRGBNormal>};
   pcl::PointCloud<pcl::PointXYZRGBNormal>::Ptr candid_result_cloud {new pcl::PointCloud<pcl::PointXYZRGBNormal>};
 
   YAMLConfig config_;
 
-  void samplePointsInTriangle(TrianglePlaneData & plane);
+  void setupLineData(TrianglePlaneData & plane);
+  void samplePointsInEdge(TrianglePlaneData & plane, int line_index);
+  bool isGraspableEdge(const MeshEdge & edge) const;
   void samplePointsInLine(const Eigen::Vector3d &norm, Eigen::Vector3d p1, Eigen::Vector3d p2, Eigen::Vector3d direction_vector, LineData & line_data);
   // void makePair
+  /// @brief sample of adaptiveSamplePointsInLine
+  struct LineSample
+  {
+    Eigen::Vector3d p;
+    bool found {false}; ///< opposite contact exists
+    Eigen::Vector3d result_n;
+    GraspData grasp;
+  };
+  void adaptiveSamplePointsInLine(const Eigen::Vector3d &norm, const Eigen::Vector3d &p1, const Eigen::Vector3d &p2, 
+                                  const Eigen::Vector3d &direction_vector, LineData & line_data);
+  LineSample evaluateLineSample(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, const Eigen::Vector3d &direction_vector);
+  void subdivideLine(const Eigen::Vector3d &norm, const LineSample &s1, const LineSample &s2, 
+                     const Eigen::Vector3d &direction_vector, LineData & line_data);
   void makePair(const Eigen::Vector3d &norm, Eigen::Vector3d new_p, Eigen::Vector3d direction_vector, LineData & line_data);
+  int precheckConstraints(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, const Eigen::Vector3d &direction_vector) const;
+  bool findPair(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, Eigen::Vector3d &result_p, Eigen::Vector3d &result_n) const;
+  void addPair(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, const Eigen::Vector3d &direction_vector,
+               const Eigen::Vector3d &result_p, const Eigen::Vector3d &result_n, LineData & line_data);
+  void addPair(const Eigen::Vector3d &norm, const GraspData &gd, const Eigen::Vector3d &result_n, LineData & line_data);
+  GraspData makeGraspData(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, const Eigen::Vector3d &direction_vector,
+                          const Eigen::Vector3d &result_p) const;
 
   void sample();
   void analyticSample ();
   void randomSample ();
+  void randomSample (long begin, long end);
+  void convergentSample ();
+  void anytimeGenerate ();
+  std::vector<int> getEdgeSampleTasks() const;
+  std::vector<double> getFaceSampleWeights() const;
+  void replicateSymmetricGrasps();
+  void poissonDiskSample ();
   void collisionCheck();
   void collisionCheck(GraspData &grasp);
+  std::vector<double> getCandidateHalfWidths(GraspData &grasp);
+  void computeClearance();
+  void selectBVType();
   void simplifyContGraspCandidates();
 };
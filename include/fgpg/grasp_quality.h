@@ -0,0 +1,73 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+#include "fgpg/grap_data.h"
+
+/**
+ * @brief Two-finger contact pairs in structure-of-arrays layout (one column per coordinate)
+ * 
+ * Contact 0 is the sampled point, contact 1 the opposite one; normals point out of the object.
+ */
+struct ContactPairBatch
+{
+  Eigen::ArrayX3d p0, p1;
+  Eigen::ArrayX3d n0, n1;
+
+  void resize(Eigen::Index size);
+  Eigen::Index size() const { return p0.rows(); }
+};
+
+/// @brief Quality terms of a batch (see scoreContactPairs)
+struct GraspQualityBatch
+{
+  Eigen::ArrayXd cone_margin; ///< 1: closing direction on both normals, 0: on the friction cone
+  Eigen::ArrayXd opposition; ///< (1 - n0.n1) / 2, 1: antipodal normals
+  Eigen::ArrayXd quality; ///< cone_margin * opposition, 0 without force closure
+};
+
+/**
+ * @brief Antipodal quality of the contact pairs
+ * 
+ * The fingers close along the line between the contacts. The pair is force closure
+ * if that line lies in both friction cones (half angle atan(mu)); the cone margin
+ * scales the smaller cosine to the line between the cone and the normal.
+ */
+void scoreContactPairs(const ContactPairBatch & batch, double friction_coefficient, GraspQualityBatch & scores);
+
+const int kGraspQualityBatchSize = 256;
+
+/**
+ * @brief Sets GraspData::quality of every grasp with two points and normals
+ * (the others get 0), scoring in batches of kGraspQualityBatchSize
+ */
+void scoreGraspQuality(std::vector<GraspData> & grasps, double friction_coefficient);
@@ -0,0 +1,89 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+#include "fgpg/triangle_plane_data.h"
+
+/**
+ * @brief Directed edge of a triangle; half-edge h belongs to face h / 3
+ */
+struct HalfEdge
+{
+  int vertex; ///< origin vertex
+  int next; ///< next half-edge in the same face
+  int twin {-1}; ///< opposite half-edge, -1 on open or non-manifold edges
+};
+
+/**
+ * @brief Geometric edge shared by one or two faces
+ */
+struct MeshEdge
+{
+  int half_edge[2] {-1, -1}; ///< half_edge[1] is -1 on open or non-manifold edges
+  double length {0.0};
+  double dihedral_angle {0.0}; ///< angle between the face normals (rad), 0: coplanar
+  bool concave {false}; ///< the faces form a valley
+};
+
+/**
+ * @brief Half-edge adjacency of a triangle mesh (faces keep the order of the input triangles)
+ */
+class HalfEdgeMesh
+{
+public:
+  /**
+   * @param mesh triangles
+   * @param weld_tolerance distance under which two corners are the same vertex (m)
+   */
+  void build(const std::vector<TrianglePlaneData> &mesh, double weld_tolerance);
+
+  static int face(int half_edge) { return half_edge / 3; }
+
+  /// @brief index of the half-edge in TrianglePlaneData::line_data
+  static int lineIndex(int half_edge) { return (half_edge % 3 + 1) % 3; }
+
+  /// @brief face across the half-edge, -1 if there is none
+  int neighbour(int half_edge) const
+  {
+    int twin = half_edges_[half_edge].twin;
+    return twin < 0 ? -1 : face(twin);
+  }
+
+  const std::vector<HalfEdge> & getHalfEdges() const { return half_edges_; }
+  const std::vector<MeshEdge> & getEdges() const { return edges_; }
+  const std::vector<Eigen::Vector3d> & getVertices() const { return vertices_; }
+
+private:
+  std::vector<Eigen::Vector3d> vertices_;
+  std::vector<HalfEdge> half_edges_;
+  std::vector<MeshEdge> edges_;
+};
@@ -0,0 +1,65 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+/**
+ * @brief Direction binning by the faces of a geodesic icosphere
+ * 
+ * Subdivision s has 20 * 4^s spherical triangles. The edge midpoints are projected 
+ * to the sphere, so the cells are not of equal area: their solid angles range from 
+ * 0.95 to 1.15 of the mean at s = 1 and from 0.93 to 1.21 (max / min 1.3) from s = 3 on. 
+ * Cell c of subdivision s is the parent of cells 4c .. 4c+3 of subdivision s+1 and the 
+ * children tile it exactly, so the cell of a direction at a coarser subdivision 
+ * is its fine cell divided by 4 per level.
+ */
+class IcosphereBinning
+{
+public:
+  void build(int subdivision);
+
+  int getSubdivision() const { return static_cast<int>(levels_.size()) - 1; }
+  int getNumCells() const { return levels_.empty() ? 0 : levels_.back().size(); }
+
+  /// @brief cell of a unit direction at the finest subdivision
+  int getCell(const Eigen::Vector3d &direction) const;
+
+private:
+  struct Face
+  {
+    Eigen::Vector3d a, b, c; ///< counter-clockwise seen from outside
+  };
+
+  /// @brief smallest of the three edge functions, positive inside the face
+  static double inside(const Face &face, const Eigen::Vector3d &direction);
+
+  std::vector<std::vector<Face> > levels_;
+};
@@ -36,6 +36,11 @@
  *
  */
 
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
 #include "fgpg/triangle_plane_data.h"
 
 void
@@ -45,4 +50,40 @@ void
 randPSurface (const std::vector <TrianglePlaneData>& planes, 
 std::vector<double> &cumulativeAreas, double totalArea, 
 Eigen::Vector3d& p, Eigen::Vector3d& n, 
-double r, double r1, double r2);
\ No newline at end of file
+double r, double r1, double r2);
+
+void
+randPTriangle (const TrianglePlaneData& plane, double r1, double r2,
+               Eigen::Vector3d& p, Eigen::Vector3d& n);
+
+/**
+ * @brief Counter-based uniform random number in [0, 1)
+ * 
+ * The value only depends on (seed, index, stream), so each sample can draw its own 
+ * numbers in any order or thread and the result stays identical.
+ */
+double
+counterUniform (std::uint64_t seed, std::uint64_t index, std::uint32_t stream);
+
+/**
+ * @brief Walker's alias table for O(1) sampling from a discrete distribution
+ * @see Vose, "A linear algorithm for generating random numbers with a given distribution"
+ */
+class AliasTable
+{
+public:
+  /// @brief the table is empty if there are no weights or they sum to zero
+  void build (const std::vector<double>& weights);
+
+  /**
+   * @param u1, u2 uniform random numbers in [0, 1)
+   * @return -1 if the table is empty
+   */
+  int sample (double u1, double u2) const;
+
+  size_t size () const { return prob_.size (); }
+
+private:
+  std::vector<double> prob_;
+  std::vector<int> alias_;
+};
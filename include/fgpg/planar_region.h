@@ -0,0 +1,60 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+#include "fgpg/half_edge_mesh.h"
+#include "fgpg/triangle_plane_data.h"
+
+/**
+ * @brief Connected coplanar triangles which form one planar polygon
+ */
+struct PlanarRegion
+{
+  Eigen::Vector3d normal; ///< normal of the seed triangle
+  std::vector<int> triangles;
+  double area {0.0};
+  int num_boundary_edges {0};
+};
+
+/**
+ * @brief Group connected coplanar triangles into planar regions
+ * 
+ * Triangles sharing an edge join the region when the angle between their normal and
+ * the normal of the region seed is within angle_tolerance. Sets TrianglePlaneData::region_id
+ * and clears LineData::boundary of the edges inside a region.
+ * 
+ * @param mesh triangles (modified)
+ * @param half_edge_mesh adjacency of the triangles
+ * @param angle_tolerance (rad)
+ */
+std::vector<PlanarRegion> buildPlanarRegions(std::vector<TrianglePlaneData> &mesh, 
+                                             const HalfEdgeMesh &half_edge_mesh, double angle_tolerance);
@@ -0,0 +1,135 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Open-addressing (linear probing) hash map from a packed bin key to a count
+ * 
+ * Memory grows with the number of occupied bins only. Bins whose count drops 
+ * to zero keep their slot.
+ */
+class SparseHistogram
+{
+public:
+  SparseHistogram() { clear(); }
+
+  void clear()
+  {
+    keys_.assign(16, empty());
+    counts_.assign(16, 0);
+    size_ = 0;
+  }
+
+  /// @return count of the bin after the update
+  int add(std::uint64_t key, int count = 1)
+  {
+    if ((size_ + 1) * 2 > keys_.size()) rehash(keys_.size() * 2);
+
+    size_t i = find(key);
+    if (keys_[i] == empty())
+    {
+      keys_[i] = key;
+      size_++;
+    }
+    counts_[i] += count;
+    return counts_[i];
+  }
+
+  int get(std::uint64_t key) const
+  {
+    size_t i = find(key);
+    return keys_[i] == empty() ? 0 : counts_[i];
+  }
+
+  /// @brief number of occupied slots
+  size_t size() const { return size_; }
+
+  size_t memoryUsage() const 
+  { 
+    return keys_.capacity() * sizeof(std::uint64_t) + counts_.capacity() * sizeof(int); 
+  }
+
+  /// @brief non-zero bins in ascending key order
+  std::vector<std::pair<std::uint64_t, int> > getSortedEntries() const
+  {
+    std::vector<std::pair<std::uint64_t, int> > entries;
+    entries.reserve(size_);
+    for (size_t i = 0; i < keys_.size(); i++)
+    {
+      if (keys_[i] != empty() && counts_[i] != 0) entries.push_back(std::make_pair(keys_[i], counts_[i]));
+    }
+    std::sort(entries.begin(), entries.end());
+    return entries;
+  }
+
+private:
+  static std::uint64_t empty() { return ~0ULL; }
+
+  static std::uint64_t mix(std::uint64_t x)
+  {
+    // SplitMix64 finalizer
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  size_t find(std::uint64_t key) const
+  {
+    const size_t mask = keys_.size() - 1;
+    size_t i = mix(key) & mask;
+    while (keys_[i] != empty() && keys_[i] != key) i = (i + 1) & mask;
+    return i;
+  }
+
+  void rehash(size_t capacity)
+  {
+    std::vector<std::uint64_t> keys;
+    std::vector<int> counts;
+    keys.swap(keys_);
+    counts.swap(counts_);
+    keys_.assign(capacity, empty());
+    counts_.assign(capacity, 0);
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+      if (keys[i] == empty()) continue;
+      size_t j = find(keys[i]);
+      keys_[j] = keys[i];
+      counts_[j] = counts[i];
+    }
+  }
+
+  std::vector<std::uint64_t> keys_;
+  std::vector<int> counts_;
+  size_t size_ {0};
+};
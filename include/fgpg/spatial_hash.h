@@ -0,0 +1,70 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <Eigen/Dense>
+
+/**
+ * @brief Integer cell coordinate of a uniform grid used as a hash key
+ */
+struct SpatialHashKey
+{
+  int64_t x, y, z;
+
+  SpatialHashKey() : x(0), y(0), z(0) {}
+  SpatialHashKey(int64_t x, int64_t y, int64_t z) : x(x), y(y), z(z) {}
+
+  SpatialHashKey(const Eigen::Ref<const Eigen::Vector3d> &point, double inverse_cell_size)
+  : x(static_cast<int64_t>(std::floor(point(0) * inverse_cell_size))),
+    y(static_cast<int64_t>(std::floor(point(1) * inverse_cell_size))),
+    z(static_cast<int64_t>(std::floor(point(2) * inverse_cell_size)))
+  {}
+
+  SpatialHashKey offset(int dx, int dy, int dz) const
+  {
+    return SpatialHashKey(x + dx, y + dy, z + dz);
+  }
+
+  bool operator==(const SpatialHashKey &other) const
+  {
+    return x == other.x && y == other.y && z == other.z;
+  }
+};
+
+struct SpatialHashKeyHasher
+{
+  size_t operator()(const SpatialHashKey &key) const
+  {
+    // large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+    return static_cast<size_t>((key.x * 73856093) ^ (key.y * 19349663) ^ (key.z * 83492791));
+  }
+};
@@ -0,0 +1,70 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+/**
+ * @brief Rotational (C_n) or mirror symmetry of a mesh
+ * 
+ * The fundamental region is the wedge of angle 2 pi / n starting at ref_direction 
+ * for a rotation, and the half space on the +axis side for a mirror.
+ */
+struct SymmetryGroup
+{
+  Eigen::Vector3d center {Eigen::Vector3d::Zero()};
+  Eigen::Vector3d axis {Eigen::Vector3d::UnitZ()}; ///< rotation axis or mirror plane normal
+  Eigen::Vector3d ref_direction {Eigen::Vector3d::UnitX()}; ///< orthogonal to axis
+  int fold {1}; ///< n of C_n, 1: no rotational symmetry
+  bool mirror {false};
+
+  /// @brief number of group elements, identity included
+  int order() const { return mirror ? 2 : fold; }
+
+  /// @brief group elements except the identity (a mirror has a negative determinant)
+  std::vector<Eigen::Isometry3d> getTransforms() const;
+
+  bool inFundamentalRegion(const Eigen::Vector3d &point) const;
+};
+
+/**
+ * @brief Find the largest symmetry of a vertex set
+ * 
+ * The principal axes through the centroid are the candidates: rotations by 
+ * 2 pi / n (n = max_fold .. 2) about each of them are tried first, and mirror 
+ * planes normal to them if none holds. A candidate holds if every transformed 
+ * vertex has a vertex within tolerance.
+ * 
+ * @param vertices welded vertices of the mesh
+ * @param max_fold (>= 2)
+ * @param tolerance (m)
+ * @return a group of order 1 if no symmetry is found
+ */
+SymmetryGroup detectSymmetry(const std::vector<Eigen::Vector3d> &vertices, int max_fold, double tolerance);
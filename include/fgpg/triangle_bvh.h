@@ -0,0 +1,129 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+#include "fgpg/triangle_plane_data.h"
+
+/**
+ * @brief Bounding volume hierarchy of axis-aligned boxes over mesh triangles for ray queries
+ * 
+ * Keeps a pointer to the triangles, which must outlive it.
+ */
+class TriangleBVH
+{
+public:
+  void build(const std::vector<TrianglePlaneData> &planes);
+
+  /**
+   * @brief Distance from the palm to the object along its normal
+   * 
+   * Nearest hit along +direction: among the triangles the ray (origin, direction) hits, 
+   * the smallest non-negative distance of origin to the triangle plane. This deliberately 
+   * differs from getGraspDistance, which ignores the return value of 
+   * calcLinePlaneIntersection and tests its (then unset) point anyway.
+   * 
+   * @return infinity if nothing is hit
+   */
+  double getPalmDistance(const Eigen::Vector3d &origin, const Eigen::Vector3d &direction) const;
+
+  /// @brief calls visit(triangle index) for the triangles whose leaf box the ray (t >= 0) hits
+  template <typename Visitor>
+  void raycast(const Eigen::Vector3d &origin, const Eigen::Vector3d &direction, Visitor visit) const;
+
+  /// @brief calls visit(triangle index) for the triangles whose leaf box overlaps box
+  template <typename Visitor>
+  void query(const Eigen::AlignedBox3d &box, Visitor visit) const;
+
+private:
+  struct Node
+  {
+    Eigen::AlignedBox3d box;
+    int left {-1}; ///< -1: leaf
+    int right {-1};
+    int begin {0}; ///< leaf: range in indices_
+    int end {0};
+  };
+
+  int buildNode(int begin, int end, const std::vector<Eigen::Vector3d> &centroids);
+  static bool hitBox(const Eigen::AlignedBox3d &box, const Eigen::Vector3d &origin, const Eigen::Vector3d &inverse_direction);
+
+  const std::vector<TrianglePlaneData> *planes_ {nullptr};
+  std::vector<Node> nodes_;
+  std::vector<int> indices_;
+};
+
+template <typename Visitor>
+void TriangleBVH::raycast(const Eigen::Vector3d &origin, const Eigen::Vector3d &direction, Visitor visit) const
+{
+  if (nodes_.empty()) return;
+
+  const Eigen::Vector3d inverse_direction = direction.cwiseInverse();
+  int stack[64];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const Node & node = nodes_[stack[--top]];
+    if (!hitBox(node.box, origin, inverse_direction)) continue;
+
+    if (node.left < 0)
+    {
+      for (int i = node.begin; i < node.end; i++) visit(indices_[i]);
+      continue;
+    }
+    stack[top++] = node.left;
+    stack[top++] = node.right;
+  }
+}
+
+template <typename Visitor>
+void TriangleBVH::query(const Eigen::AlignedBox3d &box, Visitor visit) const
+{
+  if (nodes_.empty()) return;
+
+  int stack[64];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const Node & node = nodes_[stack[--top]];
+    if (!node.box.intersects(box)) continue;
+
+    if (node.left < 0)
+    {
+      for (int i = node.begin; i < node.end; i++) visit(indices_[i]);
+      continue;
+    }
+    stack[top++] = node.left;
+    stack[top++] = node.right;
+  }
+}
@@ -41,6 +41,7 @@ struct LineData
   std::pair<Eigen::Vector3d, Eigen::Vector3d> limit_points;
   std::vector<GraspData> sampled_grasp_data;
   bool graspable {false};
+  bool boundary {true}; ///< false for an edge inside a planar region (not sampled)
 
   Eigen::Vector3d center_dist;
 
@@ -117,6 +118,7 @@ struct TrianglePlaneData
   std::vector < Eigen::Vector3d > points {3};
   double area;
   Eigen::Vector3d incenter;
+  int region_id {-1}; ///< planar region (see buildPlanarRegions)
 
   std::vector < LineData > line_data {3};
 
@@ -0,0 +1,54 @@
+/*
+ * BSD 2-Clause License
+ * 
+ * Copyright (c) 2020, Suhan Park
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+#include "fgpg/triangle_plane_data.h"
+
+/**
+ * @brief Merge triangle corners closer than tolerance into shared vertices
+ * 
+ * A vertex is compared only with the vertices in the neighbouring cells of a hash grid
+ * whose cell size is the tolerance. The first vertex of a cluster is kept as its representative.
+ * 
+ * @param mesh triangles
+ * @param tolerance welding distance (m), must be positive
+ * @param vertices shared vertices (output)
+ * @param indices vertex indices of each triangle, same order as mesh (output)
+ * @return number of degenerate triangles (two or more corners welded together)
+ */
+int weldVertices(const std::vector<TrianglePlaneData> &mesh, double tolerance,
+                 std::vector<Eigen::Vector3d> &vertices, std::vector<Eigen::Vector3i> &indices);
+
+inline bool isDegenerate(const Eigen::Vector3i &index)
+{
+  return index(0) == index(1) || index(1) == index(2) || index(2) == index(0);
+}
@@ -94,7 +94,7 @@ static std::vector<TrianglePlaneData> buildTriangleData(pcl::PolygonMesh & mesh)
 
   return triangles;
 }
-void mTomm(pcl::PolygonMesh & mesh)
+inline void mTomm(pcl::PolygonMesh & mesh)
 {
   Eigen::Matrix4d transform;
   transform.setIdentity();
@@ -105,7 +105,7 @@ void mTomm(pcl::PolygonMesh & mesh)
   pcl::toPCLPointCloud2(cloud, mesh.cloud);
 }
 
-pcl::PolygonMesh transformPos(pcl::PolygonMesh mesh, Eigen::Isometry3d transform)
+inline pcl::PolygonMesh transformPos(pcl::PolygonMesh mesh, Eigen::Isometry3d transform)
 {
   pcl::PolygonMesh transform_mesh = mesh;
   Eigen::Matrix4d transform_matrix;
@@ -29,6 +29,8 @@
 #pragma once
 #include <yaml-cpp/yaml.h>
 
+#include "fgpg/grasp_constraints.h"
+
 struct YAMLConfig
 {
   void loadConfig(std::string file_name)
@@ -40,14 +42,67 @@ struct YAMLConfig
 
     gripper_params = yamlnode["gripper_params"].as<std::vector<double> >();
     gripper_depth_epsilon = yamlnode["gripper_depth_epsilon"].as<double> ();
+    roll_angles = yamlnode["roll_angles"].as<std::vector<double> >();
 
     point_distance = yamlnode["point_distance"].as<double> ();
+    merge_coplanar_triangles = yamlnode["merge_coplanar_triangles"].as<bool>();
+    coplanar_angle_tolerance = yamlnode["coplanar_angle_tolerance"].as<double>();
+    use_symmetry = yamlnode["use_symmetry"].as<bool>();
+    symmetry_max_fold = yamlnode["symmetry_max_fold"].as<int>();
+    symmetry_tolerance = yamlnode["symmetry_tolerance"].as<double>();
+    adaptive_line_sampling = yamlnode["adaptive_line_sampling"].as<bool>();
+    adaptive_initial_distance = yamlnode["adaptive_initial_distance"].as<double>();
+    adaptive_width_tolerance = yamlnode["adaptive_width_tolerance"].as<double>();
     random_point_num = yamlnode["random_point_num"].as<int>();
+    random_seed = yamlnode["random_seed"].as<unsigned long long>();
+    num_threads = yamlnode["num_threads"].as<int>();
+    anytime_budget_ms = yamlnode["anytime_budget_ms"].as<double>();
+    coverage_convergence = yamlnode["coverage_convergence"].as<bool>();
+    convergence_batch_size = yamlnode["convergence_batch_size"].as<int>();
+    convergence_entropy_threshold = yamlnode["convergence_entropy_threshold"].as<double>();
+    poisson_disk_radius_scale = yamlnode["poisson_disk_radius_scale"].as<double>();
+    poisson_disk_max_failures = yamlnode["poisson_disk_max_failures"].as<int>();
 
     remove_same_pose = yamlnode["remove_same_pose"].as<bool>();
     same_dist = yamlnode["same_dist"].as<double>();
     same_angle = yamlnode["same_angle"].as<double>();
 
+    grasp_constraints.clear();
+    for (const auto & node : yamlnode["grasp_constraints"])
+    {
+      auto vec = [&node](const char * key) { 
+        auto v = node[key].as<std::vector<double> >();
+        return Eigen::Vector3d(v[0], v[1], v[2]);
+      };
+      GraspConstraint constraint;
+      constraint.name = node["type"].as<std::string>();
+      if (constraint.name == "table")
+      {
+        constraint.type = GraspConstraint::TABLE;
+        constraint.axis = vec("normal").normalized();
+        constraint.height = node["height"].as<double>();
+        constraint.margin = node["margin"].as<double>();
+      }
+      else if (constraint.name == "approach_cone")
+      {
+        constraint.type = GraspConstraint::APPROACH_CONE;
+        constraint.axis = vec("axis").normalized();
+        constraint.half_angle = node["half_angle"].as<double>();
+      }
+      else if (constraint.name == "workspace_box")
+      {
+        constraint.type = GraspConstraint::WORKSPACE_BOX;
+        constraint.min_point = vec("min");
+        constraint.max_point = vec("max");
+      }
+      else
+      {
+        std::cout << "[WARN] unknown grasp constraint: " << constraint.name << std::endl;
+        continue;
+      }
+      grasp_constraints.push_back(constraint);
+    }
+
     output_file_suffix = yamlnode["output_file_suffix"].as<std::string>();
 
     camera_position = yamlnode["camera_position"].as<std::vector<double> >();
@@ -71,23 +126,69 @@ struct YAMLConfig
 
     leaf_size = yamlnode["leaf_size"].as<double> ();
     num_orientation_leaf = yamlnode["num_orientation_leaf"].as<int> ();
+    print_grasp_distances = yamlnode["print_grasp_distances"].as<bool>();
+    orientation_binning = yamlnode["orientation_binning"].as<std::string>();
+    icosphere_subdivision = yamlnode["icosphere_subdivision"].as<int>();
+    coverage_histogram = yamlnode["coverage_histogram"].as<std::string>();
+    coverage_multi_resolution_levels = yamlnode["coverage_multi_resolution_levels"].as<int>();
+    coverage_bootstrap_resamples = yamlnode["coverage_bootstrap_resamples"].as<int>();
+    coverage_bootstrap_confidence = yamlnode["coverage_bootstrap_confidence"].as<double>();
 
     use_hand_mesh_model = yamlnode["use_hand_mesh_model"].as<bool>();
     hand_model_path = yamlnode["hand_model_path"].as<std::string>();
+
+    // Collision
+    bv_type = yamlnode["bv_type"].as<std::string>();
+    bv_auto_sample_num = yamlnode["bv_auto_sample_num"].as<int>();
+    weld_tolerance = yamlnode["weld_tolerance"].as<double>();
+    use_proxy_collision = yamlnode["use_proxy_collision"].as<bool>();
+    proxy_resolution = yamlnode["proxy_resolution"].as<double>();
+    compute_clearance = yamlnode["compute_clearance"].as<bool>();
+    clearance_upper_bound = yamlnode["clearance_upper_bound"].as<double>();
+    multi_width_evaluation = yamlnode["multi_width_evaluation"].as<bool>();
+    compute_grasp_quality = yamlnode["compute_grasp_quality"].as<bool>();
+    friction_coefficient = yamlnode["friction_coefficient"].as<double>();
+    compute_contact_area = yamlnode["compute_contact_area"].as<bool>();
+    contact_area_tolerance = yamlnode["contact_area_tolerance"].as<double>();
+    contact_angle_tolerance = yamlnode["contact_angle_tolerance"].as<double>();
+    width_margins = yamlnode["width_margins"].as<std::vector<double> >();
+
+    // Benchmark
+    benchmark_point_distances = yamlnode["benchmark_point_distances"].as<std::vector<double> >();
+    benchmark_random_point_nums = yamlnode["benchmark_random_point_nums"].as<std::vector<int> >();
   }
 
   std::string point_generation_method;
 
   std::vector<double> gripper_params;
   double gripper_depth_epsilon;
+  std::vector<double> roll_angles;
 
   double point_distance;
+  bool merge_coplanar_triangles;
+  double coplanar_angle_tolerance;
+  bool use_symmetry;
+  int symmetry_max_fold;
+  double symmetry_tolerance;
+  bool adaptive_line_sampling;
+  double adaptive_initial_distance;
+  double adaptive_width_tolerance;
   int random_point_num;
+  unsigned long long random_seed;
+  int num_threads;
+  double anytime_budget_ms;
+  bool coverage_convergence;
+  int convergence_batch_size;
+  double convergence_entropy_threshold;
+  double poisson_disk_radius_scale;
+  int poisson_disk_max_failures;
 
   bool remove_same_pose;
   double same_dist;
   double same_angle;
 
+  std::vector<GraspConstraint> grasp_constraints;
+
   std::string output_file_suffix;
 
   std::vector<double> camera_position;
@@ -111,7 +212,34 @@ struct YAMLConfig
 
   double leaf_size;
   int num_orientation_leaf;
+  bool print_grasp_distances;
+  std::string orientation_binning;
+  int icosphere_subdivision;
+  std::string coverage_histogram;
+  int coverage_multi_resolution_levels;
+  int coverage_bootstrap_resamples;
+  double coverage_bootstrap_confidence;
 
   bool use_hand_mesh_model;
   std::string hand_model_path;
+
+  // Collision
+  std::string bv_type;
+  int bv_auto_sample_num;
+  double weld_tolerance;
+  bool use_proxy_collision;
+  double proxy_resolution;
+  bool compute_clearance;
+  double clearance_upper_bound;
+  bool multi_width_evaluation;
+  bool compute_grasp_quality;
+  double friction_coefficient;
+  bool compute_contact_area;
+  double contact_area_tolerance;
+  double contact_angle_tolerance;
+  std::vector<double> width_margins;
+
+  // Benchmark
+  std::vector<double> benchmark_point_distances;
+  std::vector<int> benchmark_random_point_nums;
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <ros/ros.h>
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+
+#include "fgpg/grasp_point_generator.h"
+#include "fgpg/grasp_coverage_evaluator.h"
+#include "fgpg/coverage_utils.h"
+#include "fgpg/yaml_config.h"
+#include "fgpg/vtk_mesh_utils.h"
+
+/// @brief one generation run of the benchmark
+struct BenchmarkRun
+{
+  std::string mesh_file;
+  std::string method;
+  double parameter; ///< point_distance or random_point_num
+  double wall_ms {0.0};
+  double cpu_ms {0.0}; ///< all threads
+  size_t num_candidates {0};
+  size_t num_feasible {0};
+  double full_entropy {0.0};
+  double pos_entropy {0.0};
+  bool pareto {false};
+};
+
+void runGeneration(const YAMLConfig & config, const std::vector<TrianglePlaneData> & triangles, BenchmarkRun & run)
+{
+  std::clock_t cpu_begin = std::clock();
+  auto wall_begin = std::chrono::steady_clock::now();
+
+  GraspPointGenerator gpg;
+  gpg.setConfig(config);
+  gpg.setMesh(triangles);
+  gpg.generate();
+
+  run.wall_ms = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_begin).count() * 1e3;
+  run.cpu_ms = 1e3 * (std::clock() - cpu_begin) / CLOCKS_PER_SEC;
+
+  run.num_candidates = gpg.getNumCandidates();
+  run.num_feasible = gpg.getGraspData().size();
+
+  GraspCoverageEvaluator gce;
+  setupCoverageEvaluator(config, triangles, getCoverageGraspPoints(gpg.getGraspData()), gce);
+  gce.getNumberOfBin();
+  run.full_entropy = gce.getFullEntropy();
+  run.pos_entropy = gce.getPosEntropy();
+}
+
+/**
+ * @brief Marks the runs of each mesh that no other run of the mesh beats in both 
+ * CPU time and full entropy
+ */
+void markPareto(std::vector<BenchmarkRun> & runs)
+{
+  for (auto & run : runs)
+  {
+    run.pareto = true;
+    for (const auto & other : runs)
+    {
+      if (other.mesh_file != run.mesh_file) continue;
+      if (other.cpu_ms <= run.cpu_ms && other.full_entropy >= run.full_entropy &&
+          (other.cpu_ms < run.cpu_ms || other.full_entropy > run.full_entropy))
+      {
+        run.pareto = false;
+        break;
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 4) 
+  {
+    std::cout << "Usage: "<< argv[0] << " config.yaml output.csv mesh_model.stl [mesh_model.stl ...]" << std::endl;
+    return -1;
+  }
+
+  YAMLConfig config;
+  try
+  {
+    config.loadConfig(std::string(argv[1]));
+  }
+  catch(std::exception &e)
+  {
+      ROS_ERROR("Failed to load yaml file");
+  }
+  config.display_figure = false;
+  config.anytime_budget_ms = 0;
+  config.coverage_convergence = false; // the sweep sets random_point_num
+
+  std::vector<BenchmarkRun> runs;
+  for (int i = 3; i < argc; i++)
+  {
+    std::string file_name (argv[i]);
+    pcl::PolygonMesh mesh;
+    pcl::io::loadPolygonFile(file_name, mesh);
+    std::vector<TrianglePlaneData> triangles = buildTriangleData(mesh);
+    if (triangles.empty())
+    {
+      std::cout << "[WARN] failed to load mesh: " << file_name << std::endl;
+      continue;
+    }
+
+    for (double point_distance : config.benchmark_point_distances)
+    {
+      YAMLConfig run_config = config;
+      run_config.point_generation_method = "geometry_analysis";
+      run_config.point_distance = point_distance;
+      BenchmarkRun run;
+      run.mesh_file = file_name;
+      run.method = run_config.point_generation_method;
+      run.parameter = point_distance;
+      runGeneration(run_config, triangles, run);
+      runs.push_back(run);
+    }
+    for (int random_point_num : config.benchmark_random_point_nums)
+    {
+      YAMLConfig run_config = config;
+      run_config.point_generation_method = "random_sample";
+      run_config.random_point_num = random_point_num;
+      BenchmarkRun run;
+      run.mesh_file = file_name;
+      run.method = run_config.point_generation_method;
+      run.parameter = random_point_num;
+      runGeneration(run_config, triangles, run);
+      runs.push_back(run);
+    }
+  }
+  markPareto(runs);
+
+  std::ofstream output_file(argv[2]);
+  output_file << "mesh,method,parameter,wall_ms,cpu_ms,candidates,feasible,full_entropy,pos_entropy,"
+              << "full_entropy_per_cpu_s,pareto" << std::endl;
+  for (const auto & run : runs)
+  {
+    std::cout << "[Benchmark] " << run.mesh_file << " " << run.method << " " << run.parameter << ": " 
+              << run.wall_ms << " ms (cpu " << run.cpu_ms << " ms), feasible: " << run.num_feasible 
+              << "/" << run.num_candidates << ", full_entropy: " << run.full_entropy 
+              << (run.pareto ? " (pareto)" : "") << std::endl;
+    output_file << run.mesh_file << "," << run.method << "," << run.parameter << "," << run.wall_ms << "," 
+                << run.cpu_ms << "," << run.num_candidates << "," << run.num_feasible << "," 
+                << run.full_entropy << "," << run.pos_entropy << "," 
+                << (run.cpu_ms > 0 ? run.full_entropy / run.cpu_ms * 1e3 : 0.0) << "," << run.pareto << std::endl;
+  }
+  return 0;
+}
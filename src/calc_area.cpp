@@ -0,0 +1,143 @@
+#include "fgpg/calc_area.h"
+
+#include <algorithm>
+
+namespace
+{
+const double kMaxAngleTolerance = 1.5; // rad
+}
+
+GraspAreaCalculator::GraspAreaCalculator(const FCLGripperBase & gripper, const std::vector<TrianglePlaneData> & planes, 
+                                         const TriangleBVH & bvh)
+: gripper_(gripper), planes_(planes), bvh_(bvh) {}
+
+void GraspAreaCalculator::setTolerance(double distance, double angle)
+{
+  distance_tolerance_ = distance;
+  // below pi / 2, as calcPadArea divides by the pad normal component of a facing triangle
+  cos_angle_tolerance_ = std::cos(std::min(std::max(angle, 0.0), kMaxAngleTolerance));
+}
+
+void GraspAreaCalculator::calcArea(const Eigen::Isometry3d & transform, double half_width, double areas[2])
+{
+  areas[0] = calcPadArea(transform, half_width, 1.0);
+  areas[1] = calcPadArea(transform, -half_width, -1.0);
+}
+
+bool GraspAreaCalculator::clip(double a, double b, double c)
+{
+  const double (*in)[2] = polygon_[current_];
+  double (*out)[2] = polygon_[1 - current_];
+  const int n = size_[current_];
+  int m = 0;
+  bool overflow = false;
+  for (int i = 0; i < n; i++)
+  {
+    const double *p = in[i];
+    const double *q = in[(i + 1) % n];
+    double fp = a * p[0] + b * p[1] + c;
+    double fq = a * q[0] + b * q[1] + c;
+    if (fp >= 0)
+    {
+      if (m >= kMaxVertices) { overflow = true; break; }
+      out[m][0] = p[0];
+      out[m][1] = p[1];
+      m++;
+    }
+    if ((fp >= 0) != (fq >= 0))
+    {
+      if (m >= kMaxVertices) { overflow = true; break; }
+      double t = fp / (fp - fq);
+      out[m][0] = p[0] + t * (q[0] - p[0]);
+      out[m][1] = p[1] + t * (q[1] - p[1]);
+      m++;
+    }
+  }
+  current_ = 1 - current_;
+  if (overflow)
+  {
+    // more vertices than a clipped triangle can have (degenerate input): drop the polygon
+    size_[current_] = 0;
+    return false;
+  }
+  size_[current_] = m;
+  return m >= 3;
+}
+
+double GraspAreaCalculator::calcPadArea(const Eigen::Isometry3d & transform, double pad_z, double pad_normal_z)
+{
+  const double x_min = -gripper_.d, x_max = gripper_.l - gripper_.d;
+  const double y_max = gripper_.y1l / 2, y_min = -y_max;
+
+  Eigen::AlignedBox3d box;
+  box.setEmpty();
+  for (int i = 0; i < 8; i++)
+  {
+    Eigen::Vector3d corner ((i & 1) ? x_max : x_min, (i & 2) ? y_max : y_min, 
+                            pad_z + ((i & 4) ? distance_tolerance_ : -distance_tolerance_));
+    box.extend(transform * corner);
+  }
+
+  const Eigen::Matrix3d rotation_t = transform.linear().transpose();
+  const Eigen::Vector3d translation = transform.translation();
+  double area = 0.0;
+  bvh_.query(box, [&](int index) {
+    const TrianglePlaneData & plane = planes_[index];
+    // facing the pad: the outward normal is along the pad normal
+    Eigen::Vector3d n = rotation_t * plane.normal;
+    if (n(2) * pad_normal_z < cos_angle_tolerance_) return;
+
+    current_ = 0;
+    size_[0] = 3;
+    for (int k = 0; k < 3; k++)
+    {
+      Eigen::Vector3d q = rotation_t * (plane.points[k] - translation);
+      polygon_[0][k][0] = q(0);
+      polygon_[0][k][1] = q(1);
+    }
+    // height over the pad plane on the triangle: dz = c0 + gx * x + gy * y
+    const Eigen::Vector3d q0 = rotation_t * (plane.points[0] - translation);
+    const double gx = -n(0) / n(2), gy = -n(1) / n(2);
+    const double c0 = q0(2) - gx * q0(0) - gy * q0(1) - pad_z;
+
+    if (!clip(1, 0, -x_min) || !clip(-1, 0, x_max) || !clip(0, 1, -y_min) || !clip(0, -1, y_max) ||
+        !clip(-gx, -gy, distance_tolerance_ - c0) || !clip(gx, gy, distance_tolerance_ + c0))
+    {
+      return;
+    }
+
+    // shoelace
+    const double (*polygon)[2] = polygon_[current_];
+    const int n_vertices = size_[current_];
+    double twice_area = 0.0;
+    for (int i = 0; i < n_vertices; i++)
+    {
+      const double *p = polygon[i];
+      const double *q = polygon[(i + 1) % n_vertices];
+      twice_area += p[0] * q[1] - q[0] * p[1];
+    }
+    area += std::abs(twice_area) / 2;
+  });
+  return area;
+}
+
+void computeContactAreas(std::vector<GraspData> & grasps, const FCLGripperBase & gripper, 
+                         const std::vector<TrianglePlaneData> & planes, const TriangleBVH & bvh,
+                         double distance_tolerance, double angle_tolerance)
+{
+  const long num = grasps.size();
+
+  #pragma omp parallel
+  {
+    GraspAreaCalculator calculator (gripper, planes, bvh);
+    calculator.setTolerance(distance_tolerance, angle_tolerance);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (long i = 0; i < num; i++)
+    {
+      GraspData & grasp = grasps[i];
+      if (grasp.points.size() < 2) continue;
+      calculator.calcArea(grasp.hand_transform, grasp.getDist() / 2, grasp.contact_area);
+    }
+  }
+}
@@ -0,0 +1,148 @@
+#include "fgpg/collision_proxy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+bool triangleBoxOverlap(const Eigen::Vector3d &center, const Eigen::Vector3d &half_size,
+                        const Eigen::Vector3d &a, const Eigen::Vector3d &b, const Eigen::Vector3d &c)
+{
+  const Eigen::Vector3d v[3] = {a - center, b - center, c - center};
+  const Eigen::Vector3d e[3] = {v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+
+  // separation along an axis: projected triangle interval vs projected box radius
+  auto separated = [&](const Eigen::Vector3d &axis)
+  {
+    double p0 = axis.dot(v[0]);
+    double p1 = axis.dot(v[1]);
+    double p2 = axis.dot(v[2]);
+    double r = half_size.dot(axis.cwiseAbs());
+    return std::min({p0, p1, p2}) > r || std::max({p0, p1, p2}) < -r;
+  };
+
+  // 9 cross products of the box axes and the triangle edges
+  for (int i = 0; i < 3; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      Eigen::Vector3d axis = Eigen::Vector3d::Unit(i).cross(e[j]);
+      if (axis.squaredNorm() > 0.0 && separated(axis))
+        return false;
+    }
+  }
+
+  // box face normals
+  for (int i = 0; i < 3; i++)
+  {
+    if (separated(Eigen::Vector3d::Unit(i)))
+      return false;
+  }
+
+  // triangle normal
+  Eigen::Vector3d normal = e[0].cross(e[1]);
+  if (normal.squaredNorm() > 0.0 && separated(normal))
+    return false;
+
+  return true;
+}
+
+void CollisionProxy::build(const std::vector<TrianglePlaneData> &mesh, double resolution, double margin)
+{
+  resolution_ = resolution;
+  inverse_resolution_ = 1.0 / resolution;
+
+  // a little larger cell for the overlap test so that touching triangles are never missed
+  const Eigen::Vector3d half_size = Eigen::Vector3d::Constant(resolution_ / 2 + margin);
+
+  std::unordered_set<SpatialHashKey, SpatialHashKeyHasher> cells;
+  for (const auto & triangle : mesh)
+  {
+    const auto & a = triangle.points[0];
+    const auto & b = triangle.points[1];
+    const auto & c = triangle.points[2];
+
+    SpatialHashKey lower(a.cwiseMin(b).cwiseMin(c), inverse_resolution_);
+    SpatialHashKey upper(a.cwiseMax(b).cwiseMax(c), inverse_resolution_);
+
+    for (int64_t x = lower.x; x <= upper.x; x++)
+    {
+      for (int64_t y = lower.y; y <= upper.y; y++)
+      {
+        for (int64_t z = lower.z; z <= upper.z; z++)
+        {
+          Eigen::Vector3d center = (Eigen::Vector3d(x, y, z) + Eigen::Vector3d::Constant(0.5)) * resolution_;
+          if (triangleBoxOverlap(center, half_size, a, b, c))
+          {
+            cells.insert(SpatialHashKey(x, y, z));
+          }
+        }
+      }
+    }
+  }
+  num_cells_ = cells.size();
+
+  // merge the cells of each (y, z) column into runs along x
+  std::unordered_map<SpatialHashKey, std::vector<int64_t>, SpatialHashKeyHasher> columns;
+  for (const auto & cell : cells)
+  {
+    columns[SpatialHashKey(0, cell.y, cell.z)].push_back(cell.x);
+  }
+
+  boxes_.clear();
+  runs_.clear();
+  bound_.setEmpty();
+  for (auto & column : columns)
+  {
+    auto & xs = column.second;
+    std::sort(xs.begin(), xs.end());
+
+    size_t begin = 0;
+    for (size_t i = 1; i <= xs.size(); i++)
+    {
+      if (i < xs.size() && xs[i] == xs[i-1] + 1) continue;
+
+      Run run;
+      run.x0 = xs[begin];
+      run.x1 = xs[i-1];
+      run.box_id = boxes_.size();
+
+      Eigen::Vector3d min_point(run.x0, column.first.y, column.first.z);
+      Eigen::Vector3d max_point(run.x1 + 1, column.first.y + 1, column.first.z + 1);
+      Eigen::AlignedBox3d box(min_point * resolution_ - Eigen::Vector3d::Constant(margin), 
+                              max_point * resolution_ + Eigen::Vector3d::Constant(margin));
+      boxes_.push_back(box);
+      bound_.extend(box);
+      runs_[column.first].push_back(run);
+
+      begin = i;
+    }
+  }
+}
+
+void CollisionProxy::findBoxes(const Eigen::AlignedBox3d &query, std::vector<int> &box_ids) const
+{
+  box_ids.clear();
+  if (!bound_.intersects(query))
+    return;
+
+  // margins are smaller than a cell, so the neighbouring columns cover them
+  SpatialHashKey lower(query.min(), inverse_resolution_);
+  SpatialHashKey upper(query.max(), inverse_resolution_);
+
+  for (int64_t y = lower.y - 1; y <= upper.y + 1; y++)
+  {
+    for (int64_t z = lower.z - 1; z <= upper.z + 1; z++)
+    {
+      auto it = runs_.find(SpatialHashKey(0, y, z));
+      if (it == runs_.end()) continue;
+
+      for (const auto & run : it->second)
+      {
+        if (boxes_[run.box_id].intersects(query))
+        {
+          box_ids.push_back(run.box_id);
+        }
+      }
+    }
+  }
+}
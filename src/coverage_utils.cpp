@@ -0,0 +1,97 @@
+#include "fgpg/coverage_utils.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > getCoverageGraspPoints(const std::vector<GraspData> & grasps)
+{
+  std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > grasp_data;
+  grasp_data.reserve(grasps.size());
+  for (const auto & grasp : grasps)
+  {
+    grasp_data.push_back(std::make_pair(grasp.hand_transform.translation(), grasp.hand_transform.linear().col(0)));
+  }
+  return grasp_data;
+}
+
+void setupCoverageEvaluator(const YAMLConfig & config, const std::vector<TrianglePlaneData> & triangles, 
+                            const std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > & grasp_data, 
+                            GraspCoverageEvaluator & gce)
+{
+  gce.setModel(triangles);
+  gce.setLeafSize(config.leaf_size, config.num_orientation_leaf);
+  gce.setSparseHistogram(config.coverage_histogram == "sparse");
+  gce.setIcosphereBinning(config.orientation_binning == "icosphere" ? config.icosphere_subdivision : -1);
+  gce.setGraspPoints(grasp_data);
+}
+
+void computeCoverageEntropy(const YAMLConfig & config, GraspCoverageEvaluator & gce, 
+                            double & full_entropy, double & pos_entropy, std::ostream & out)
+{
+  auto binAndMeasure = [&](const std::string & histogram) {
+    auto begin = std::chrono::steady_clock::now();
+    gce.getNumberOfBin();
+    full_entropy = gce.getFullEntropy();
+    pos_entropy = gce.getPosEntropy();
+    auto end = std::chrono::steady_clock::now();
+    out << "[Coverage] " << histogram << " histogram: " << gce.getHistogramMemory() / 1024.0 << " KiB, "
+              << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+  };
+
+  if (config.coverage_histogram != "both")
+  {
+    binAndMeasure(config.coverage_histogram);
+    return;
+  }
+
+  gce.setSparseHistogram(true);
+  binAndMeasure("sparse");
+  const double sparse_full_entropy = full_entropy;
+  const double sparse_pos_entropy = pos_entropy;
+
+  gce.setSparseHistogram(false);
+  binAndMeasure("dense");
+  if (sparse_full_entropy != full_entropy || sparse_pos_entropy != pos_entropy)
+  {
+    out << "[WARN] the sparse and dense histograms differ: full_entropy " << sparse_full_entropy << " / " << full_entropy
+              << ", pos_entropy " << sparse_pos_entropy << " / " << pos_entropy << std::endl;
+  }
+}
+
+void writeEntropyCurve(const GraspCoverageEvaluator & gce, int num_levels, const std::string & file_name)
+{
+  std::ofstream curve_file(file_name);
+  curve_file << "leaf_size,orientation_size,occupied_bins,pos_entropy,full_entropy" << std::endl;
+  for (const auto & level : gce.getMultiResolutionEntropy(num_levels))
+  {
+    std::cout << "[Coverage] leaf_size: " << level.leaf_size << ", orientation: " << level.orientation_size 
+              << ", bins: " << level.occupied_bins << ", pos_entropy: " << level.pos_entropy 
+              << ", full_entropy: " << level.full_entropy << std::endl;
+    curve_file << level.leaf_size << "," << level.orientation_size << "," << level.occupied_bins << "," 
+               << level.pos_entropy << "," << level.full_entropy << std::endl;
+  }
+  std::cout << "[Coverage] entropy curve written to " << file_name << std::endl;
+}
+
+CoverageBootstrap printBootstrapIntervals(const YAMLConfig & config, const GraspCoverageEvaluator & gce, 
+                                          const std::vector<double> & distances)
+{
+  auto begin = std::chrono::steady_clock::now();
+  CoverageBootstrap bootstrap = gce.getBootstrapIntervals(config.coverage_bootstrap_resamples, 
+                                                          config.coverage_bootstrap_confidence, config.random_seed, distances);
+  auto end = std::chrono::steady_clock::now();
+
+  auto printInterval = [&bootstrap](const std::string & name, const BootstrapInterval & interval) {
+    std::cout << "[Bootstrap] " << name << ": " << interval.estimate << " [" << interval.lower << ", " << interval.upper << "] (" 
+              << bootstrap.confidence * 100 << "%, " << bootstrap.num_resamples << " resamples)" << std::endl;
+  };
+  printInterval("full_entropy", bootstrap.full_entropy);
+  printInterval("pos_entropy", bootstrap.pos_entropy);
+  if (!distances.empty())
+  {
+    printInterval("average distance", bootstrap.average_distance);
+  }
+  std::cout << "[Bootstrap] " << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+  return bootstrap;
+}
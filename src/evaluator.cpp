@@ -1,11 +1,18 @@
 
 #include <ros/ros.h>
 
+#include <chrono>
 #include <fstream>
+#include <map>
+#include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "fgpg/grasp_point_generator.h"
 #include "fgpg/fcl_utils.h"
 #include "fgpg/hsv2rgb.h"
 #include "fgpg/grasp_coverage_evaluator.h"
+#include "fgpg/coverage_utils.h"
 #include "fgpg/yaml_config.h"
 #include "fgpg/vtk_mesh_utils.h"
 #include "fgpg/calc_area.h"
@@ -16,34 +23,41 @@ void readVector(ifstream &stream, Eigen::Vector3d & vec)
   stream >> vec(0) >> g >> vec(1)  >> g >> vec(2) >> g ;
 }
 
-int main(int argc, char** argv)
+/// @brief one line of the batch manifest
+struct EvaluationEntry
 {
-  if (argc < 4) 
-  {
-    std::cout << "Usage: "<< argv[0] << "config.yaml mesh_model.std result_file.txt" << std::endl;
-    return -1;
-  }
+  std::string mesh_file;
+  std::string result_file;
+  std::string label;
+};
 
-  YAMLConfig config;
-  try
-  {
-    config.loadConfig(std::string(argv[1]));
-  }
-  catch(std::exception &e)
-  {
-      ROS_ERROR("Failed to load yaml file");
-  }
+struct EvaluationResult
+{
+  bool ok {false};
+  size_t num_grasps {0};
+  double average_distance {0.0};
+  double full_entropy {0.0};
+  double pos_entropy {0.0};
+  double elapsed_ms {0.0};
+  CoverageBootstrap bootstrap; ///< only with coverage_bootstrap_resamples
+};
 
-  GraspCoverageEvaluator gce;
+/// @brief a mesh shared by the entries of a batch (loaded once)
+struct EvaluationMesh
+{
+  pcl::PolygonMesh mesh;
+  std::vector<TrianglePlaneData> triangles;
+  TriangleBVH bvh; ///< refers to triangles
+};
 
-  std::string file_name (argv[2]);
-  std::string result_file_name (argv[3]);
+bool readResultFile(const std::string & result_file_name, std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > & grasp_data,
+                    std::vector<Eigen::Isometry3d> & grasp_transforms, std::vector<double> & grasp_widths)
+{
   std::ifstream result_file(result_file_name);
-  std::cout << file_name <<std::endl;
-
-  std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > grasp_data;
-  std::vector<Eigen::Isometry3d> grasp_transforms;
-  std::vector<double> grasp_widths;
+  if (!result_file.is_open())
+  {
+    return false;
+  }
   while (result_file)
   {
     Eigen::Vector3d grasp_bottom, grasp_surface, axis, approach, binormal;
@@ -54,6 +68,11 @@ int main(int argc, char** argv)
     readVector(result_file, approach);
     readVector(result_file, binormal);
     result_file >> grasp_width;
+    if (!result_file)
+    {
+      // end of file (the last successful record is followed only by whitespace)
+      break;
+    }
     grasp_data.push_back(std::make_pair(grasp_bottom,approach));
 
     Eigen::Isometry3d grasp_transform;
@@ -70,38 +89,256 @@ int main(int argc, char** argv)
       // gd.hand_transform.linear().col(1) = norm.cross(direction_vector); // Y = Z cross X
       // gd.hand_transform.linear().col(2) = norm; // Z
   }
+  return true;
+}
+
+std::vector<EvaluationEntry> readManifest(const std::string & manifest_file_name)
+{
+  std::vector<EvaluationEntry> entries;
+  std::ifstream manifest_file(manifest_file_name);
+  std::string line;
+  while (std::getline(manifest_file, line))
+  {
+    std::istringstream line_stream(line);
+    EvaluationEntry entry;
+    if (!(line_stream >> entry.mesh_file) || entry.mesh_file[0] == '#')
+    {
+      continue;
+    }
+    if (!(line_stream >> entry.result_file))
+    {
+      std::cout << "[WARN] manifest line without a result file: " << line << std::endl;
+      continue;
+    }
+    if (!(line_stream >> entry.label))
+    {
+      entry.label = entry.result_file;
+    }
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+std::string escapeJSON(const std::string & str)
+{
+  std::string escaped;
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\') escaped.push_back('\\');
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+/**
+ * @brief Evaluates every entry of a manifest ("mesh_file result_file [label]" per line, # comments)
+ * and writes one table of distances and entropies (.json: JSON array, otherwise CSV)
+ * 
+ * Every mesh is loaded once; the entries are spread over num_threads workers.
+ */
+int runBatch(const YAMLConfig & config, const std::string & manifest_file_name, const std::string & output_file_name)
+{
+  std::vector<EvaluationEntry> entries = readManifest(manifest_file_name);
+  if (entries.empty())
+  {
+    std::cout << "[Batch] no entries in " << manifest_file_name << std::endl;
+    return -1;
+  }
+
+  // std::map keeps the nodes in place, so the BVHs can refer to their triangles
+  std::map<std::string, EvaluationMesh> meshes;
+  for (const auto & entry : entries)
+  {
+    if (meshes.count(entry.mesh_file) > 0) continue;
+    EvaluationMesh & data = meshes[entry.mesh_file];
+    pcl::io::loadPolygonFile(entry.mesh_file, data.mesh);
+    data.triangles = buildTriangleData(data.mesh);
+    data.bvh.build(data.triangles);
+    if (data.triangles.empty())
+    {
+      std::cout << "[WARN] failed to load mesh: " << entry.mesh_file << std::endl;
+    }
+  }
+  std::cout << "[Batch] " << entries.size() << " entries, " << meshes.size() << " meshes" << std::endl;
+
+#ifdef _OPENMP
+  if (config.num_threads > 0)
+  {
+    omp_set_num_threads(config.num_threads);
+  }
+#endif
+
+  FCLGripper gripper_model;
+  gripper_model.setParams(config);
+  std::vector<EvaluationResult> results (entries.size());
+  const long num_entries = entries.size();
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (long i = 0; i < num_entries; i++)
+  {
+    auto begin = std::chrono::steady_clock::now();
+    const EvaluationMesh & data = meshes.at(entries[i].mesh_file);
+    std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > grasp_data;
+    std::vector<Eigen::Isometry3d> grasp_transforms;
+    std::vector<double> grasp_widths;
+    EvaluationResult & result = results[i];
+    if (data.triangles.empty() || !readResultFile(entries[i].result_file, grasp_data, grasp_transforms, grasp_widths) || grasp_data.empty())
+    {
+      #pragma omp critical
+      std::cout << "[WARN] skipped: " << entries[i].label << " (" << entries[i].result_file << ")" << std::endl;
+      continue;
+    }
+
+    result.num_grasps = grasp_data.size();
+    std::vector<double> dists;
+    result.average_distance = getAverageGraspDistance(grasp_transforms, gripper_model, data.bvh, &dists);
+
+    GraspCoverageEvaluator gce;
+    setupCoverageEvaluator(config, data.triangles, grasp_data, gce);
+    std::ostringstream coverage_log;
+    computeCoverageEntropy(config, gce, result.full_entropy, result.pos_entropy, coverage_log);
+    if (config.coverage_bootstrap_resamples > 0)
+    {
+      result.bootstrap = gce.getBootstrapIntervals(config.coverage_bootstrap_resamples, config.coverage_bootstrap_confidence, 
+                                                   config.random_seed, dists);
+    }
+    result.ok = true;
+    result.elapsed_ms = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() * 1e3;
+
+    #pragma omp critical
+    std::cout << coverage_log.str() << "[Batch] " << entries[i].label << ": " << result.num_grasps << " grasps, ave: " << result.average_distance 
+              << ", full_entropy: " << result.full_entropy << ", pos_entropy: " << result.pos_entropy << std::endl;
+  }
+
+  std::ofstream output_file(output_file_name);
+  output_file.precision(10);
+  bool json = output_file_name.size() >= 5 && output_file_name.compare(output_file_name.size() - 5, 5, ".json") == 0;
+  const bool bootstrap = config.coverage_bootstrap_resamples > 0;
+  if (json)
+  {
+    output_file << "[" << std::endl;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+      const auto & result = results[i];
+      output_file << "  {\"label\": \"" << escapeJSON(entries[i].label) << "\", \"mesh\": \"" << escapeJSON(entries[i].mesh_file) 
+                  << "\", \"result\": \"" << escapeJSON(entries[i].result_file) << "\", \"ok\": " << (result.ok ? "true" : "false")
+                  << ", \"num_grasps\": " << result.num_grasps << ", \"average_distance\": " << result.average_distance
+                  << ", \"full_entropy\": " << result.full_entropy << ", \"pos_entropy\": " << result.pos_entropy 
+                  << ", \"elapsed_ms\": " << result.elapsed_ms;
+      if (bootstrap)
+      {
+        const auto & b = result.bootstrap;
+        output_file << ", \"average_distance_ci\": [" << b.average_distance.lower << ", " << b.average_distance.upper << "]"
+                    << ", \"full_entropy_ci\": [" << b.full_entropy.lower << ", " << b.full_entropy.upper << "]"
+                    << ", \"pos_entropy_ci\": [" << b.pos_entropy.lower << ", " << b.pos_entropy.upper << "]";
+      }
+      output_file << "}" << (i + 1 < entries.size() ? "," : "") << std::endl;
+    }
+    output_file << "]" << std::endl;
+  }
+  else
+  {
+    output_file << "label,mesh,result,ok,num_grasps,average_distance,full_entropy,pos_entropy,elapsed_ms";
+    if (bootstrap)
+    {
+      output_file << ",average_distance_lower,average_distance_upper,full_entropy_lower,full_entropy_upper,"
+                  << "pos_entropy_lower,pos_entropy_upper";
+    }
+    output_file << std::endl;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+      const auto & result = results[i];
+      output_file << entries[i].label << "," << entries[i].mesh_file << "," << entries[i].result_file << "," << result.ok << ","
+                  << result.num_grasps << "," << result.average_distance << "," << result.full_entropy << "," 
+                  << result.pos_entropy << "," << result.elapsed_ms;
+      if (bootstrap)
+      {
+        const auto & b = result.bootstrap;
+        output_file << "," << b.average_distance.lower << "," << b.average_distance.upper << "," << b.full_entropy.lower << "," 
+                    << b.full_entropy.upper << "," << b.pos_entropy.lower << "," << b.pos_entropy.upper;
+      }
+      output_file << std::endl;
+    }
+  }
+  std::cout << "[Batch] written to " << output_file_name << std::endl;
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 4) 
+  {
+    std::cout << "Usage: "<< argv[0] << "config.yaml mesh_model.std result_file.txt" << std::endl;
+    std::cout << "       "<< argv[0] << "config.yaml --batch manifest.txt [output.csv|output.json]" << std::endl;
+    return -1;
+  }
+
+  YAMLConfig config;
+  try
+  {
+    config.loadConfig(std::string(argv[1]));
+  }
+  catch(std::exception &e)
+  {
+      ROS_ERROR("Failed to load yaml file");
+  }
+
+  if (std::string(argv[2]) == "--batch")
+  {
+    return runBatch(config, argv[3], argc > 4 ? argv[4] : "evaluation.csv");
+  }
+
+  GraspCoverageEvaluator gce;
+
+  std::string file_name (argv[2]);
+  std::string result_file_name (argv[3]);
+  std::cout << file_name <<std::endl;
+
+  std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > grasp_data;
+  std::vector<Eigen::Isometry3d> grasp_transforms;
+  std::vector<double> grasp_widths;
+  readResultFile(result_file_name, grasp_data, grasp_transforms, grasp_widths);
   // grasp_transforms.resize(5);
   
   FCLGripper gripper_model;
-  // gripper_model.setParams(config.gripper_params[0], config.gripper_params[1], config.gripper_params[2], config.gripper_params[3],config.gripper_params[4],config.gripper_params[5]);
+  gripper_model.setParams(config);
 
   // Mesh Load
   pcl::PolygonMesh mesh;
   pcl::io::loadPolygonFile(file_name, mesh);
   std::vector<TrianglePlaneData> triangles = buildTriangleData(mesh);
 
+  TriangleBVH bvh;
+  bvh.build(triangles);
   std::vector<double> dists;
-  for(auto& trans : grasp_transforms)
+  double average = getAverageGraspDistance(grasp_transforms, gripper_model, bvh, &dists);
+  if (config.print_grasp_distances)
   {
-    std::cout << "transform: " << std::endl << trans.matrix() << std::endl;
-    double dist = getGraspDistance(trans, gripper_model, triangles);
-    dists.push_back(dist);
-    std::cout << dist  << std::endl; 
+    for (size_t i = 0; i < grasp_transforms.size(); i++)
+    {
+      std::cout << "transform: " << std::endl << grasp_transforms[i].matrix() << std::endl;
+      std::cout << dists[i]  << std::endl; 
+    }
   }
-  double average = std::accumulate(dists.begin(), dists.end(), 0.0) / grasp_transforms.size();
   std::cout << "ave: " << average << std::endl;
 
-  gce.setModel(triangles);
-  gce.setLeafSize(config.leaf_size,config.num_orientation_leaf);
-  gce.setGraspPoints(grasp_data);
-  gce.getNumberOfBin();
-
-  double full_entropy = gce.getFullEntropy();
-  double pos_entropy = gce.getPosEntropy();
+  setupCoverageEvaluator(config, triangles, grasp_data, gce);
+  double full_entropy, pos_entropy;
+  computeCoverageEntropy(config, gce, full_entropy, pos_entropy);
 
   std::cout << "full_entropy: " << full_entropy << std::endl;
   std::cout << "pos_entropy: " << pos_entropy << std::endl;
 
+  if (config.coverage_bootstrap_resamples > 0)
+  {
+    printBootstrapIntervals(config, gce, dists);
+  }
+
+  if (config.coverage_multi_resolution_levels > 0)
+  {
+    std::string result_name = result_file_name.substr(0, result_file_name.find_last_of('.'));
+    writeEntropyCurve(gce, config.coverage_multi_resolution_levels, result_name + "_entropy_curve.csv");
+  }
+
   if(config.display_figure)
   {
     pcl::visualization::PCLVisualizer vis ("VOXELIZED SAMPLES CLOUD");
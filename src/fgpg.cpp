@@ -1,12 +1,12 @@
 #include <ros/ros.h>
 
-#include <ctime>
 #include <fstream>
 
 #include "fgpg/grasp_point_generator.h"
 #include "fgpg/fcl_utils.h"
 #include "fgpg/hsv2rgb.h"
 #include "fgpg/grasp_coverage_evaluator.h"
+#include "fgpg/coverage_utils.h"
 #include "fgpg/yaml_config.h"
 #include "fgpg/vtk_mesh_utils.h"
 #include "fgpg/calc_area.h"
@@ -40,11 +40,6 @@ int main(int argc, char** argv)
       ROS_ERROR("Failed to load yaml file");
   }
 
-  // random with microsec
-  struct timespec spec;
-  clock_gettime(CLOCK_REALTIME, &spec);
-  srand(spec.tv_nsec);
-
   std::string file_name (argv[2]);
 
   pcl::PolygonMesh mesh;
@@ -80,24 +75,24 @@ int main(int argc, char** argv)
 
   GraspCoverageEvaluator gce;
 
-  const auto & grasp_cand = gpg.getGraspData();
-  std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > grasp_datas;
-  grasp_datas.reserve(grasp_cand.size());
-  for(const auto & grasp : grasp_cand)
-  {
-    grasp_datas.push_back(std::make_pair(grasp.hand_transform.translation(), grasp.hand_transform.linear().col(0)));
-  }
-
-  gce.setModel(triangles);
-  gce.setLeafSize(config.leaf_size,config.num_orientation_leaf);
-  gce.setGraspPoints(grasp_datas);
-  gce.getNumberOfBin();
-  double full_entropy = gce.getFullEntropy();
-  double pos_entropy = gce.getPosEntropy();
-  double average_distance = gpg.getAverageDistance();
+  setupCoverageEvaluator(config, triangles, getCoverageGraspPoints(gpg.getGraspData()), gce);
+  double full_entropy, pos_entropy;
+  computeCoverageEntropy(config, gce, full_entropy, pos_entropy);
+  std::vector<double> distances;
+  double average_distance = gpg.getAverageDistance(&distances);
   std::cout << "average distance: " << average_distance << std::endl;
   std::cout << "full_entropy: " << full_entropy << std::endl;
   std::cout << "pos_entropy: " << pos_entropy << std::endl;
 
+  if (config.coverage_bootstrap_resamples > 0)
+  {
+    printBootstrapIntervals(config, gce, distances);
+  }
+
+  if (config.coverage_multi_resolution_levels > 0)
+  {
+    writeEntropyCurve(gce, config.coverage_multi_resolution_levels, obj_name + "_entropy_curve.csv");
+  }
+
   return 0;
 }
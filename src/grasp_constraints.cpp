@@ -0,0 +1,98 @@
+#include "fgpg/grasp_constraints.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+bool inCone(const Eigen::Vector3d &direction, const Eigen::Vector3d &axis, double half_angle)
+{
+  return direction.dot(axis) >= std::cos(half_angle) * direction.norm() * axis.norm();
+}
+
+/// @brief slab test of a segment against an axis-aligned box
+bool segmentIntersectsBox(const Eigen::Vector3d &a, const Eigen::Vector3d &b, 
+                          const Eigen::Vector3d &min_point, const Eigen::Vector3d &max_point)
+{
+  double t0 = 0.0, t1 = 1.0;
+  Eigen::Vector3d d = b - a;
+  for (int i = 0; i < 3; i++)
+  {
+    if (std::fabs(d(i)) < 1e-12)
+    {
+      if (a(i) < min_point(i) || a(i) > max_point(i)) return false;
+      continue;
+    }
+    double ta = (min_point(i) - a(i)) / d(i);
+    double tb = (max_point(i) - a(i)) / d(i);
+    if (ta > tb) std::swap(ta, tb);
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+    if (t0 > t1) return false;
+  }
+  return true;
+}
+
+}
+
+bool GraspConstraint::accepts(const Eigen::Isometry3d &hand_transform) const
+{
+  const Eigen::Vector3d center = hand_transform.translation();
+  const Eigen::Vector3d approach = hand_transform.linear().col(0);
+  switch (type)
+  {
+    case TABLE:
+      // the hand must not come up from below the table
+      return approach.dot(axis) <= 0 && center.dot(axis) >= height + margin;
+    case APPROACH_CONE:
+      return inCone(approach, axis, half_angle);
+    case WORKSPACE_BOX:
+      return (center.array() >= min_point.array()).all() && (center.array() <= max_point.array()).all();
+  }
+  return true;
+}
+
+bool GraspConstraint::mayAccept(const Eigen::Vector3d &center_begin, const Eigen::Vector3d &center_end,
+                                const std::vector<Eigen::Vector3d> &approach_directions) const
+{
+  switch (type)
+  {
+    case TABLE:
+    {
+      if (std::max(center_begin.dot(axis), center_end.dot(axis)) < height + margin) return false;
+      for (const auto & approach : approach_directions)
+        if (approach.dot(axis) <= 0) return true;
+      return false;
+    }
+    case APPROACH_CONE:
+    {
+      for (const auto & approach : approach_directions)
+        if (inCone(approach, axis, half_angle)) return true;
+      return false;
+    }
+    case WORKSPACE_BOX:
+      return segmentIntersectsBox(center_begin, center_end, min_point, max_point);
+  }
+  return true;
+}
+
+int findViolatedConstraint(const std::vector<GraspConstraint> &constraints, const Eigen::Isometry3d &hand_transform)
+{
+  for (size_t i = 0; i < constraints.size(); i++)
+  {
+    if (!constraints[i].accepts(hand_transform)) return i;
+  }
+  return -1;
+}
+
+int findViolatedConstraint(const std::vector<GraspConstraint> &constraints, 
+                           const Eigen::Vector3d &center_begin, const Eigen::Vector3d &center_end,
+                           const std::vector<Eigen::Vector3d> &approach_directions)
+{
+  for (size_t i = 0; i < constraints.size(); i++)
+  {
+    if (!constraints[i].mayAccept(center_begin, center_end, approach_directions)) return i;
+  }
+  return -1;
+}
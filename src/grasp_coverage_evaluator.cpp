@@ -1,5 +1,10 @@
 
 #include "fgpg/grasp_coverage_evaluator.h"
+#include "fgpg/mesh_sampling.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
 
 GraspCoverageEvaluator::GraspCoverageEvaluator() {}
 
@@ -62,26 +67,175 @@ void GraspCoverageEvaluator::getNumberOfBin()
   // Compute the number of divisions needed along all axis
   div_bin_ = max_bin_ - min_bin_ + Eigen::Vector3i::Ones ();
 
-  num_points_tensor_full_.resize(div_bin_(0), div_bin_(1), div_bin_(2), orientation_size_, orientation_size_, orientation_size_);
-  num_points_tensor_full_.setZero();
-  num_points_tensor_pos_.resize(div_bin_(0), div_bin_(1), div_bin_(2));
-  num_points_tensor_pos_.setZero();
+  if (icosphere_subdivision_ >= 0)
+  {
+    orientation_dims_ << icosphere_.getNumCells(), 1, 1;
+  }
+  else
+  {
+    orientation_dims_.setConstant(orientation_size_);
+  }
+
+  if (sparse_)
+  {
+    num_points_tensor_full_.resize(0, 0, 0, 0, 0, 0);
+    num_points_tensor_pos_.resize(0, 0, 0);
+    num_points_hash_full_.clear();
+    num_points_hash_pos_.clear();
+  }
+  else
+  {
+    num_points_tensor_full_.resize(div_bin_(0), div_bin_(1), div_bin_(2), orientation_dims_(0), orientation_dims_(1), orientation_dims_(2));
+    num_points_tensor_full_.setZero();
+    num_points_tensor_pos_.resize(div_bin_(0), div_bin_(1), div_bin_(2));
+    num_points_tensor_pos_.setZero();
+  }
+  total_num_points_ = 0;
+  sum_clogc_full_ = 0;
+  sum_clogc_pos_ = 0;
+  binned_ = true;
 
   for(const auto & data : grasp_data_)
   {
-    const auto & pt = data.first;
-    const auto & ap = data.second;
-    int i = static_cast<int> ((pt[0] * inverse_leaf_size_) - min_bin_[0]);
-    int j = static_cast<int> ((pt[1] * inverse_leaf_size_) - min_bin_[1]);
-    int k = static_cast<int> ((pt[2] * inverse_leaf_size_) - min_bin_[2]);
-    int l = static_cast<int> (((ap[0]*0.99+1)/2*orientation_size_));
-    int m = static_cast<int> (((ap[1]*0.99+1)/2*orientation_size_));
-    int n = static_cast<int> (((ap[2]*0.99+1)/2*orientation_size_));
+    addToBin(data);
+  }
+}
+
+void GraspCoverageEvaluator::addGraspPoints(const std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d> > & grasp_data)
+{
+  for(const auto & data : grasp_data)
+  {
+    grasp_data_.push_back(data);
+    addToBin(data);
+  }
+}
+
+void GraspCoverageEvaluator::addGrasp(const Eigen::Vector3d & point, const Eigen::Vector3d & approach)
+{
+  addToBin(std::make_pair(point, approach), 1);
+}
 
+void GraspCoverageEvaluator::removeGrasp(const Eigen::Vector3d & point, const Eigen::Vector3d & approach)
+{
+  addToBin(std::make_pair(point, approach), -1);
+}
+
+namespace
+{
+inline double clogc(int c)
+{
+  return c > 0 ? c * std::log(static_cast<double>(c)) : 0.0;
+}
+}
+
+void GraspCoverageEvaluator::addToBin(const std::pair<Eigen::Vector3d, Eigen::Vector3d> & data, int delta)
+{
+  const auto & pt = data.first;
+  const auto & ap = data.second;
+  Eigen::Vector3i b = getPositionBin(pt, inverse_leaf_size_, min_bin_);
+  int i = b(0), j = b(1), k = b(2);
+  Eigen::Vector3i o = getOrientationBin(ap);
+  int l = o(0), m = o(1), n = o(2);
+
+  int full_count, pos_count;
+  if (sparse_)
+  {
+    std::uint64_t pos_key = (static_cast<std::uint64_t>(i) * div_bin_(1) + j) * div_bin_(2) + k;
+    std::uint64_t full_key = ((pos_key * orientation_dims_(0) + l) * orientation_dims_(1) + m) * orientation_dims_(2) + n;
+    full_count = num_points_hash_full_.add(full_key, delta);
+    pos_count = num_points_hash_pos_.add(pos_key, delta);
+  }
+  else
+  {
     // Compute the centroid leaf index
-    num_points_tensor_full_(i,j,k,l,m,n) += 1;
-    num_points_tensor_pos_(i,j,k) += 1;
+    full_count = (num_points_tensor_full_(i,j,k,l,m,n) += delta);
+    pos_count = (num_points_tensor_pos_(i,j,k) += delta);
+  }
+
+  total_num_points_ += delta;
+  sum_clogc_full_ += clogc(full_count) - clogc(full_count - delta);
+  sum_clogc_pos_ += clogc(pos_count) - clogc(pos_count - delta);
+}
+
+/**
+ * @brief H = -sum (c/N) log (c/N) = log N - (sum c log c) / N
+ */
+double GraspCoverageEvaluator::getRunningEntropy(double sum_clogc) const
+{
+  if (total_num_points_ <= 0) return 0.0;
+  return std::log(static_cast<double>(total_num_points_)) - sum_clogc / total_num_points_;
+}
+
+double GraspCoverageEvaluator::getRunningFullEntropy() const
+{
+  return getRunningEntropy(sum_clogc_full_);
+}
+
+double GraspCoverageEvaluator::getRunningPosEntropy() const
+{
+  return getRunningEntropy(sum_clogc_pos_);
+}
+
+/**
+ * @brief Position bin relative to min_bin, truncated after the shift as the dense tensor is indexed
+ */
+Eigen::Vector3i GraspCoverageEvaluator::getPositionBin(const Eigen::Vector3d & pt, double inverse_leaf_size, 
+                                                       const Eigen::Vector3i & min_bin)
+{
+  return Eigen::Vector3i(static_cast<int> ((pt[0] * inverse_leaf_size) - min_bin[0]),
+                         static_cast<int> ((pt[1] * inverse_leaf_size) - min_bin[1]),
+                         static_cast<int> ((pt[2] * inverse_leaf_size) - min_bin[2]));
+}
+
+Eigen::Vector3i GraspCoverageEvaluator::getOrientationBin(const Eigen::Vector3d & ap) const
+{
+  if (icosphere_subdivision_ >= 0)
+  {
+    return Eigen::Vector3i(icosphere_.getCell(ap.normalized()), 0, 0);
+  }
+  return Eigen::Vector3i(static_cast<int> (((ap[0]*0.99+1)/2*orientation_size_)),
+                         static_cast<int> (((ap[1]*0.99+1)/2*orientation_size_)),
+                         static_cast<int> (((ap[2]*0.99+1)/2*orientation_size_)));
+}
+
+void GraspCoverageEvaluator::setSparseHistogram(bool sparse)
+{
+  sparse_ = sparse;
+}
+
+void GraspCoverageEvaluator::setIcosphereBinning(int subdivision)
+{
+  icosphere_subdivision_ = subdivision;
+  if (subdivision >= 0)
+  {
+    icosphere_.build(subdivision);
+  }
+}
+
+size_t GraspCoverageEvaluator::getHistogramMemory() const
+{
+  if (sparse_)
+  {
+    return num_points_hash_full_.memoryUsage() + num_points_hash_pos_.memoryUsage();
+  }
+  return (num_points_tensor_full_.size() + num_points_tensor_pos_.size()) * sizeof(int);
+}
+
+/**
+ * @brief Entropy over the occupied bins
+ * 
+ * The bins are summed in key order, which is the order of the dense loops, 
+ * so the result is bit-identical to the dense backend.
+ */
+double GraspCoverageEvaluator::getEntropy(const SparseHistogram & histogram) const
+{
+  double entropy = 0;
+  for (const auto & entry : histogram.getSortedEntries())
+  {
+    double p = entry.second / (double)total_num_points_;
+    entropy -= p * std::log(p);
   }
+  return entropy;
 }
 
 void GraspCoverageEvaluator::setLeafSize(double leaf_size, int orientation_size)
@@ -93,6 +247,11 @@ void GraspCoverageEvaluator::setLeafSize(double leaf_size, int orientation_size)
 
 double GraspCoverageEvaluator::getFullEntropy()
 {
+  if (sparse_)
+  {
+    return getEntropy(num_points_hash_full_);
+  }
+
   double entropy = 0;
   for(int i=0; i<div_bin_(0); i++)
   {
@@ -100,11 +259,11 @@ double GraspCoverageEvaluator::getFullEntropy()
     {
       for(int k=0; k<div_bin_(2); k++)
       {
-        for(int l=0; l<orientation_size_; l++)
+        for(int l=0; l<orientation_dims_(0); l++)
         {
-          for(int n=0; n<orientation_size_; n++)
+          for(int n=0; n<orientation_dims_(1); n++)
           {
-            for(int m=0; m<orientation_size_; m++)
+            for(int m=0; m<orientation_dims_(2); m++)
             {
               if(num_points_tensor_full_(i,j,k,l,n,m))
               {
@@ -122,6 +281,11 @@ double GraspCoverageEvaluator::getFullEntropy()
 
 double GraspCoverageEvaluator::getPosEntropy()
 {
+  if (sparse_)
+  {
+    return getEntropy(num_points_hash_pos_);
+  }
+
   double entropy = 0;
   for(int i=0; i<div_bin_(0); i++)
   {
@@ -139,3 +303,245 @@ double GraspCoverageEvaluator::getPosEntropy()
   }
   return entropy;
 }
+
+namespace
+{
+typedef std::array<int, 6> BinKey; ///< absolute position bin and orientation bin
+typedef std::vector<std::pair<BinKey, int> > BinCounts;
+
+/// @brief sort by key (the order of the dense loops) and merge equal keys
+void mergeBins(BinCounts & bins)
+{
+  std::sort(bins.begin(), bins.end());
+  size_t n = 0;
+  for (size_t i = 0; i < bins.size(); i++)
+  {
+    if (n > 0 && bins[n-1].first == bins[i].first)
+      bins[n-1].second += bins[i].second;
+    else
+      bins[n++] = bins[i];
+  }
+  bins.resize(n);
+}
+
+/// @brief floor(b / 2), also for negative b
+inline int floorHalf(int b)
+{
+  return (b - (b < 0)) / 2;
+}
+
+double getBinEntropy(const BinCounts & bins, int total)
+{
+  double entropy = 0;
+  for (const auto & bin : bins)
+  {
+    double p = bin.second / (double)total;
+    entropy -= p * std::log(p);
+  }
+  return entropy;
+}
+}
+
+std::vector<CoverageLevel> GraspCoverageEvaluator::getMultiResolutionEntropy(int num_levels) const
+{
+  // one pass at the finest resolution, on the lattice floor(p / leaf_size) whose cells nest 
+  // (a bin at leaf_size * 2^k is the floor of the finest bin / 2^k)
+  BinCounts bins;
+  bins.reserve(grasp_data_.size());
+  for (const auto & data : grasp_data_)
+  {
+    Eigen::Vector3i o = getOrientationBin(data.second);
+    BinKey key;
+    for (int d = 0; d < 3; d++)
+    {
+      key[d] = static_cast<int> (std::floor(data.first[d] * inverse_leaf_size_));
+      key[d+3] = o(d);
+    }
+    bins.push_back(std::make_pair(key, 1));
+  }
+  mergeBins(bins);
+  const int total = grasp_data_.size();
+
+  std::vector<CoverageLevel> levels;
+  for (int k = 0; k < num_levels; k++)
+  {
+    if (k > 0)
+    {
+      for (auto & bin : bins)
+        for (int d = 0; d < 3; d++)
+          bin.first[d] = floorHalf(bin.first[d]);
+      mergeBins(bins);
+    }
+
+    BinCounts pos_bins = bins;
+    for (auto & bin : pos_bins)
+      bin.first[3] = bin.first[4] = bin.first[5] = 0;
+    mergeBins(pos_bins);
+    const double pos_entropy = getBinEntropy(pos_bins, total);
+
+    // icosphere: a parent cell is a quarter of the index, one level per subdivision
+    const bool icosphere = icosphere_subdivision_ >= 0;
+    BinCounts orientation_bins = bins;
+    for (int j = 0; icosphere ? j <= icosphere_subdivision_ 
+                              : ((orientation_size_ >> j) << j == orientation_size_ && (orientation_size_ >> j) >= 1); j++)
+    {
+      if (j > 0)
+      {
+        for (auto & bin : orientation_bins)
+        {
+          if (icosphere)
+            bin.first[3] /= 4;
+          else
+            for (int d = 3; d < 6; d++)
+              bin.first[d] /= 2;
+        }
+        mergeBins(orientation_bins);
+      }
+
+      CoverageLevel level;
+      level.leaf_size = leaf_size_ * (1 << k);
+      level.orientation_size = icosphere ? 20 * (1 << (2 * (icosphere_subdivision_ - j))) : orientation_size_ >> j;
+      level.pos_entropy = pos_entropy;
+      level.full_entropy = getBinEntropy(orientation_bins, total);
+      level.occupied_bins = orientation_bins.size();
+      levels.push_back(level);
+    }
+  }
+  return levels;
+}
+
+namespace
+{
+/// @brief compact ids of the keys (equal keys share an id)
+template <typename Key>
+std::vector<int> getCompactIds(const std::vector<Key> & keys, int & num_ids)
+{
+  std::vector<Key> unique_keys = keys;
+  std::sort(unique_keys.begin(), unique_keys.end());
+  unique_keys.erase(std::unique(unique_keys.begin(), unique_keys.end()), unique_keys.end());
+  num_ids = unique_keys.size();
+
+  std::vector<int> ids (keys.size());
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    ids[i] = std::lower_bound(unique_keys.begin(), unique_keys.end(), keys[i]) - unique_keys.begin();
+  }
+  return ids;
+}
+
+/// @brief counts of the ids of one resample, reset in O(touched bins)
+struct ResampleCounts
+{
+  std::vector<int> counts;
+  std::vector<int> touched;
+
+  void add(int id)
+  {
+    if (counts[id]++ == 0) touched.push_back(id);
+  }
+  /// @brief log N - (sum c log c) / N, and clears the counts
+  double takeEntropy(int total)
+  {
+    double sum_clogc = 0.0;
+    for (int id : touched)
+    {
+      sum_clogc += clogc(counts[id]);
+      counts[id] = 0;
+    }
+    touched.clear();
+    return std::log(static_cast<double>(total)) - sum_clogc / total;
+  }
+};
+
+/// @param confidence in (0, 1]
+BootstrapInterval getPercentileInterval(double estimate, std::vector<double> & values, double confidence)
+{
+  BootstrapInterval interval;
+  interval.estimate = estimate;
+  if (values.empty()) return interval;
+  std::sort(values.begin(), values.end());
+  const double alpha = (1.0 - confidence) / 2;
+  const size_t last = values.size() - 1;
+  interval.lower = values[static_cast<size_t> (std::floor(alpha * last))];
+  interval.upper = values[static_cast<size_t> (std::ceil((1.0 - alpha) * last))];
+  return interval;
+}
+}
+
+CoverageBootstrap GraspCoverageEvaluator::getBootstrapIntervals(int num_resamples, double confidence, std::uint64_t seed, 
+                                                                const std::vector<double> & distances) const
+{
+  if (!(confidence > 0.0 && confidence <= 1.0))
+  {
+    std::cout << "[WARN] bootstrap confidence " << confidence << " is not in (0, 1], using 0.95" << std::endl;
+    confidence = 0.95;
+  }
+  CoverageBootstrap result;
+  result.num_resamples = num_resamples;
+  result.confidence = confidence;
+  if (!binned_)
+  {
+    std::cout << "[WARN] getBootstrapIntervals: call getNumberOfBin first" << std::endl;
+    return result;
+  }
+  const long total = grasp_data_.size();
+  if (total == 0) return result;
+  const bool use_distances = (distances.size() == grasp_data_.size());
+
+  // the bins of addToBin, so the estimates equal getFullEntropy/getPosEntropy
+  std::vector<BinKey> full_keys (total);
+  std::vector<std::array<int, 3> > pos_keys (total);
+  for (long i = 0; i < total; i++)
+  {
+    Eigen::Vector3i b = getPositionBin(grasp_data_[i].first, inverse_leaf_size_, min_bin_);
+    Eigen::Vector3i o = getOrientationBin(grasp_data_[i].second);
+    for (int d = 0; d < 3; d++)
+    {
+      full_keys[i][d] = pos_keys[i][d] = b(d);
+      full_keys[i][d+3] = o(d);
+    }
+  }
+  int num_full_ids, num_pos_ids;
+  const std::vector<int> full_ids = getCompactIds(full_keys, num_full_ids);
+  const std::vector<int> pos_ids = getCompactIds(pos_keys, num_pos_ids);
+
+  ResampleCounts full_counts, pos_counts;
+  full_counts.counts.assign(num_full_ids, 0);
+  pos_counts.counts.assign(num_pos_ids, 0);
+  for (long i = 0; i < total; i++)
+  {
+    full_counts.add(full_ids[i]);
+    pos_counts.add(pos_ids[i]);
+  }
+  const double full_estimate = full_counts.takeEntropy(total);
+  const double pos_estimate = pos_counts.takeEntropy(total);
+  const double distance_estimate = use_distances ? 
+    std::accumulate(distances.begin(), distances.end(), 0.0) / total : 0.0;
+
+  std::vector<double> full_entropies (num_resamples), pos_entropies (num_resamples), 
+                      average_distances (use_distances ? num_resamples : 0);
+  #pragma omp parallel firstprivate(full_counts, pos_counts)
+  {
+    #pragma omp for schedule(static)
+    for (int r = 0; r < num_resamples; r++)
+    {
+      const std::uint64_t offset = static_cast<std::uint64_t>(r) * total;
+      double distance_sum = 0.0;
+      for (long i = 0; i < total; i++)
+      {
+        long index = std::min(total - 1, static_cast<long> (counterUniform(seed, offset + i, 0) * total));
+        full_counts.add(full_ids[index]);
+        pos_counts.add(pos_ids[index]);
+        if (use_distances) distance_sum += distances[index];
+      }
+      full_entropies[r] = full_counts.takeEntropy(total);
+      pos_entropies[r] = pos_counts.takeEntropy(total);
+      if (use_distances) average_distances[r] = distance_sum / total;
+    }
+  }
+
+  result.full_entropy = getPercentileInterval(full_estimate, full_entropies, confidence);
+  result.pos_entropy = getPercentileInterval(pos_estimate, pos_entropies, confidence);
+  result.average_distance = getPercentileInterval(distance_estimate, average_distances, confidence);
+  return result;
+}
@@ -1,6 +1,14 @@
 
 #include "fgpg/grasp_point_generator.h"
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 Eigen::Vector3d GraspPointGenerator::PCL2eigen(const PointT &pcl)
 {
   Eigen::Vector3d eig;
@@ -45,25 +53,141 @@ void GraspPointGenerator::eigen2PCL(const Eigen::Vector3d &eig, const Eigen::Vec
 const std::vector <TrianglePlaneData> & GraspPointGenerator::getTrianglePlaneData() 
 { return planes_; }
 
+const GraspPointGenerator::AnytimeReport & GraspPointGenerator::getAnytimeReport() 
+{ return anytime_report_; }
+
 const std::vector <GraspData> & GraspPointGenerator::getGraspData() 
 { return grasp_cand_collision_free_; }
 
+size_t GraspPointGenerator::getNumCandidates() const
+{ return grasps_.size(); }
+
 void GraspPointGenerator::setConfig(const YAMLConfig &config)
 {
   config_ = config;
-  collision_check_.gripper_model_.setParams(config);
+  if (config_.roll_angles.empty())
+  {
+    config_.roll_angles.push_back(0.0);
+  }
+  constraint_prechecked_.assign(config_.grasp_constraints.size(), 0);
+  constraint_rejected_.assign(config_.grasp_constraints.size(), 0);
+
+#ifdef _OPENMP
+  if (config.num_threads > 0)
+  {
+    omp_set_num_threads(config.num_threads);
+  }
+#endif
+
+  // 'auto' starts with the default type and is resolved in generate() once candidates exist
+  std::string bv_type = (config.bv_type == "auto") ? "OBBRSS" : config.bv_type;
+  collision_check_ = makeCollisionCheck(bv_type);
+  if (!collision_check_)
+  {
+    std::cout << "[WARN] unknown bv_type: " << config.bv_type << ", OBBRSS is used" << std::endl;
+    collision_check_ = makeCollisionCheck("OBBRSS");
+  }
+  collision_check_->setConfig(config);
 }
 
 void GraspPointGenerator::setMesh(const std::vector <TrianglePlaneData> triangle_mesh)
 {
   planes_ = triangle_mesh;
-  collision_check_.loadMesh(triangle_mesh);
+  collision_check_->loadMesh(triangle_mesh);
+
+  half_edge_mesh_.build(planes_, config_.weld_tolerance);
+
+  symmetry_ = SymmetryGroup();
+  face_in_region_.assign(planes_.size(), true);
+  if (config_.use_symmetry)
+  {
+    auto begin = std::chrono::steady_clock::now();
+    symmetry_ = detectSymmetry(half_edge_mesh_.getVertices(), config_.symmetry_max_fold, config_.symmetry_tolerance);
+    for (size_t i = 0; i < planes_.size(); i++)
+    {
+      Eigen::Vector3d centroid = (planes_[i].points[0] + planes_[i].points[1] + planes_[i].points[2]) / 3;
+      face_in_region_[i] = symmetry_.inFundamentalRegion(centroid);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "[Symmetry] ";
+    if (symmetry_.mirror)
+      std::cout << "mirror plane, normal: " << symmetry_.axis.transpose();
+    else if (symmetry_.fold > 1)
+      std::cout << "C" << symmetry_.fold << ", axis: " << symmetry_.axis.transpose();
+    else
+      std::cout << "none";
+    std::cout << ", center: " << symmetry_.center.transpose()
+              << ", faces in the fundamental region: " << std::count(face_in_region_.begin(), face_in_region_.end(), true) 
+              << " / " << planes_.size()
+              << ", time: " << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+  }
+  if (config_.merge_coplanar_triangles)
+  {
+    regions_ = buildPlanarRegions(planes_, half_edge_mesh_, config_.coplanar_angle_tolerance);
+  }
 }
 
 void GraspPointGenerator::generate()
 {
-  sample();
-  collisionCheck();
+  if (config_.anytime_budget_ms > 0)
+  {
+    anytimeGenerate();
+  }
+  else if (config_.coverage_convergence && config_.point_generation_method == "random_sample")
+  {
+    convergentSample();
+  }
+  else
+  {
+    sample();
+    if (config_.bv_type == "auto")
+    {
+      selectBVType();
+    }
+    collisionCheck();
+  }
+
+  if (symmetry_.order() > 1)
+  {
+    replicateSymmetricGrasps();
+  }
+
+  for (size_t i = 0; i < config_.grasp_constraints.size(); i++)
+  {
+    std::cout << "[Constraint] " << i << " " << config_.grasp_constraints[i].name 
+              << " rejected: " << constraint_prechecked_[i] << " before the contact search, " 
+              << constraint_rejected_[i] << " before the collision check" << std::endl;
+  }
+
+  if (config_.use_proxy_collision)
+  {
+    std::cout << "[Proxy] accepted: " << collision_check_->proxy_accepted_ 
+              << ", refined: " << collision_check_->proxy_refined_ << std::endl;
+  }
+  if (config_.compute_clearance)
+  {
+    computeClearance();
+  }
+  if (config_.compute_grasp_quality)
+  {
+    auto begin = std::chrono::steady_clock::now();
+    scoreGraspQuality(grasp_cand_collision_free_, config_.friction_coefficient);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "[Quality] " << grasp_cand_collision_free_.size() << " grasps, " 
+              << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+  }
+  if (config_.compute_contact_area)
+  {
+    auto begin = std::chrono::steady_clock::now();
+    TriangleBVH bvh;
+    bvh.build(planes_);
+    computeContactAreas(grasp_cand_collision_free_, collision_check_->getGripperModel(), planes_, bvh,
+                        config_.contact_area_tolerance, config_.contact_angle_tolerance);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "[ContactArea] " << grasp_cand_collision_free_.size() << " grasps, " 
+              << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+  }
 }
 
 void GraspPointGenerator::findGraspableOutline()
@@ -78,6 +202,11 @@ void GraspPointGenerator::findGraspableOutline()
       for (auto & grasp : line.sampled_grasp_data)
       {
         // std::cout << grasp << std::endl;
+        if (findViolatedConstraint(config_.grasp_constraints, grasp.hand_transform) >= 0)
+        {
+          grasp.available = false;
+          continue;
+        }
         collisionCheck(grasp);
       }
       line.calcGraspable();
@@ -92,6 +221,20 @@ void GraspPointGenerator::findGraspableOutline()
       }
     }
   }
+
+  const size_t num_original = continuous_grasp_pose_.size();
+  for (const auto & transform : symmetry_.getTransforms())
+  {
+    for (size_t i = 0; i < num_original; i++)
+    {
+      ContGraspPose cgp = continuous_grasp_pose_[i];
+      cgp.bound.first = transform * cgp.bound.first;
+      cgp.bound.second = transform * cgp.bound.second;
+      cgp.approach_direction = transform.linear() * cgp.approach_direction;
+      cgp.normal_direction = transform.linear() * cgp.normal_direction;
+      continuous_grasp_pose_.push_back(cgp);
+    }
+  }
 }
 
 void GraspPointGenerator::display(pcl::PolygonMesh& mesh)
@@ -146,7 +289,7 @@ void GraspPointGenerator::display(pcl::PolygonMesh& mesh)
         candid_result_cloud->points.push_back(point);
         candid_result_cloud->width++;   
 
-        collision_check_.gripper_model_.drawGripper(vis2, grasp.hand_transform, std::to_string(id_num++),
+        collision_check_->getGripperModel().drawGripper(vis2, grasp.hand_transform, std::to_string(id_num++),
           config_.gripper_color[0],config_.gripper_color[1],config_.gripper_color[2], 
           config_.gripper_opacity, grasp.getDist()/2);
         break;
@@ -169,7 +312,7 @@ void GraspPointGenerator::display(pcl::PolygonMesh& mesh)
         
         candid_result_cloud->points.push_back(point);
         candid_result_cloud->width++;   
-            collision_check_.gripper_model_.drawGripper(vis2, grasp.hand_transform, std::to_string(id_num++),1,0,0,config_.gripper_opacity, grasp.getDist()/2);
+            collision_check_->getGripperModel().drawGripper(vis2, grasp.hand_transform, std::to_string(id_num++),1,0,0,config_.gripper_opacity, grasp.getDist()/2);
             std::cout << "hi col" << grasp.hand_transform.matrix() << std::endl;
             i++;
             if (i == 10)
@@ -221,12 +364,12 @@ void GraspPointGenerator::display(pcl::PolygonMesh& mesh, std::vector<Eigen::Iso
       {
         if(grasp_width.size() > i)
         {
-          collision_check_.gripper_model_.drawGripper(vis2, gripper_transforms[i], std::to_string(id_num++),config_.gripper_color[0],config_.gripper_color[1],config_.gripper_color[2], config_.gripper_opacity, 
+          collision_check_->getGripperModel().drawGripper(vis2, gripper_transforms[i], std::to_string(id_num++),config_.gripper_color[0],config_.gripper_color[1],config_.gripper_color[2], config_.gripper_opacity, 
           grasp_width[i]/2);
         }
         else
         {
-          collision_check_.gripper_model_.drawGripper(vis2, gripper_transforms[i], std::to_string(id_num++),config_.gripper_color[0],config_.gripper_color[1],config_.gripper_color[2], config_.gripper_opacity);
+          collision_check_->getGripperModel().drawGripper(vis2, gripper_transforms[i], std::to_string(id_num++),config_.gripper_color[0],config_.gripper_color[1],config_.gripper_color[2], config_.gripper_opacity);
         }
       }
       vis2.spin();
@@ -292,7 +435,32 @@ void GraspPointGenerator::saveGraspCandidates(std::ofstream &of)
 
     Eigen::Quaterniond quat(new_rot);
     of << "    - [" << grasp.hand_transform.translation().transpose().format(CommaInitFmt) <<  
-              ", [" << quat.x() << ", " << quat.y() <<", " << quat.z() << ", " << quat.w() << "]]" << std::endl; 
+              ", [" << quat.x() << ", " << quat.y() <<", " << quat.z() << ", " << quat.w() << "]";
+
+    // optional per-grasp values as a trailing map
+    std::vector<std::pair<std::string, double> > fields;
+    if (config_.compute_clearance)
+      fields.push_back(std::make_pair("clearance", grasp.clearance));
+    if (config_.multi_width_evaluation)
+      fields.push_back(std::make_pair("width", grasp.width));
+    if (config_.compute_grasp_quality)
+      fields.push_back(std::make_pair("quality", grasp.quality));
+    if (config_.compute_contact_area)
+    {
+      fields.push_back(std::make_pair("contact_area_1", grasp.contact_area[0]));
+      fields.push_back(std::make_pair("contact_area_2", grasp.contact_area[1]));
+    }
+
+    if (!fields.empty())
+    {
+      of << ", {";
+      for (size_t i = 0; i < fields.size(); i++)
+      {
+        of << (i ? ", " : "") << fields[i].first << ": " << fields[i].second;
+      }
+      of << "}";
+    }
+    of << "]" << std::endl; 
     // Eigen::Quaterniond quat(new_rot);
     // of << "    - position:    " << grasp.hand_transform.translation().transpose().format(CommaInitFmt) <<  std::endl
     //    << "      orientation: [" << quat.x() << ", " << quat.y() <<", " << quat.z() << ", " << quat.w() << "]" << std::endl; 
@@ -324,23 +492,36 @@ void GraspPointGenerator::saveContGraspCandidates(std::ofstream &of)
   }
 }
 
-double GraspPointGenerator::getAverageDistance()
+double GraspPointGenerator::getAverageDistance(std::vector<double>* distances)
 {
-  std::vector<double> dists;
+  std::vector<Eigen::Isometry3d> transforms;
+  transforms.reserve(grasp_cand_collision_free_.size());
   for(auto& grasp : grasp_cand_collision_free_)
   {
-    // std::cout << "transform: " << std::endl << trans.matrix() << std::endl;
-    double dist = getGraspDistance(grasp.hand_transform, collision_check_.gripper_model_, planes_);
-    dists.push_back(dist);
-    std::cout << dist  << std::endl; 
+    transforms.push_back(grasp.hand_transform);
+  }
+
+  TriangleBVH bvh;
+  bvh.build(planes_);
+  std::vector<double> dists;
+  double average = getAverageGraspDistance(transforms, collision_check_->getGripperModel(), bvh, &dists);
+  if (config_.print_grasp_distances)
+  {
+    for (double dist : dists)
+    {
+      std::cout << dist  << std::endl; 
+    }
   }
-  double average = std::accumulate(dists.begin(), dists.end(), 0.0) / grasp_cand_collision_free_.size();
   std::cout << "ave: " << average << std::endl;
 
+  if (distances != nullptr)
+  {
+    distances->swap(dists);
+  }
   return average;
 }
 
-void GraspPointGenerator::samplePointsInTriangle(TrianglePlaneData & plane)
+void GraspPointGenerator::setupLineData(TrianglePlaneData & plane)
 {
   plane.calculateIncenter();
 
@@ -353,34 +534,50 @@ void GraspPointGenerator::samplePointsInTriangle(TrianglePlaneData & plane)
   lines.push_back(std::make_pair(p1, p3));
   lines.push_back(std::make_pair(p2, p1));
   lines.push_back(std::make_pair(p3, p2));
-  //   std::cout << "POINTS" << std::endl;
-  // std::cout << p1.transpose() << std::endl;
-  // std::cout << p2.transpose() << std::endl;
-  // std::cout << p3.transpose() << std::endl;
 
   for(int i=0; i<3; i++)
   {
     Eigen::Vector3d e = lines[i].first - lines[i].second;
     Eigen::Vector3d c = (n.cross(e)).normalized();
-    
-    // std::cout << "LINES" << std::endl;
-    // std::cout << e.transpose() << std::endl;
-    // std::cout << c.transpose() << std::endl;
-    // std::cout << n.transpose() << std::endl;
-    Eigen::Vector3d new_p1, new_p2;
-    double grasp_length = config_.gripper_params[0] - config_.gripper_depth_epsilon;
-    new_p1 = lines[i].first + c * grasp_length;
-    new_p2 = lines[i].second + c * grasp_length;
 
     plane.line_data[i].points = lines[i];
     plane.line_data[i].approach_direction = c;
-
-    samplePointsInLine (n, new_p1, new_p2, c, plane.line_data[i]);
   }
 }
 
+void GraspPointGenerator::samplePointsInEdge(TrianglePlaneData & plane, int line_index)
+{
+  auto & line_data = plane.line_data[line_index];
+  const Eigen::Vector3d & c = line_data.approach_direction;
+
+  double grasp_length = config_.gripper_params[0] - config_.gripper_depth_epsilon;
+  Eigen::Vector3d new_p1 = line_data.points.first + c * grasp_length;
+  Eigen::Vector3d new_p2 = line_data.points.second + c * grasp_length;
+
+  samplePointsInLine (plane.normal, new_p1, new_p2, c, line_data);
+}
+
+/**
+ * @brief Whether the gripper can approach a mesh edge from its faces
+ * 
+ * Open edges always are; coplanar (the palm would lie on the next face) and 
+ * concave (the next face is in the way) edges are not.
+ */
+bool GraspPointGenerator::isGraspableEdge(const MeshEdge & edge) const
+{
+  if (edge.half_edge[1] < 0) return true;
+  if (edge.concave) return false;
+  return edge.dihedral_angle >= config_.coplanar_angle_tolerance;
+}
+
 void GraspPointGenerator::samplePointsInLine(const Eigen::Vector3d &norm, Eigen::Vector3d p1, Eigen::Vector3d p2, Eigen::Vector3d direction_vector, LineData & line_data)
 {
+  if (config_.adaptive_line_sampling)
+  {
+    adaptiveSamplePointsInLine(norm, p1, p2, direction_vector, line_data);
+    return;
+  }
+
   Eigen::Vector3d u = p2 - p1; // e
   double len = u.norm(); // ||e||
   // double point_len = len - config_.point_distance;
@@ -399,48 +596,212 @@ void GraspPointGenerator::samplePointsInLine(const Eigen::Vector3d &norm, Eigen:
   }
 }
 
+/**
+ * @brief Coarse-to-fine sampling along a line
+ * 
+ * An interval is halved only if its end samples disagree, so the spacing reaches 
+ * point_distance near the feasibility boundaries and stays coarse elsewhere. 
+ * The candidates are collision-checked here and come out in order along the line.
+ */
+void GraspPointGenerator::adaptiveSamplePointsInLine(const Eigen::Vector3d &norm, const Eigen::Vector3d &p1, const Eigen::Vector3d &p2, 
+                                                     const Eigen::Vector3d &direction_vector, LineData & line_data)
+{
+  double len = (p2 - p1).norm();
+  int point_n = std::max(1, (int)round(len / config_.adaptive_initial_distance));
+
+  std::vector<LineSample> coarse (point_n + 1);
+  for (int i=0; i<point_n+1; i++)
+  {
+    coarse[i] = evaluateLineSample(norm, p1 + (p2 - p1) * ((double)i / point_n), direction_vector);
+  }
+
+  for (int i=0; i<point_n+1; i++)
+  {
+    if (i > 0)
+    {
+      subdivideLine(norm, coarse[i-1], coarse[i], direction_vector, line_data);
+    }
+    if (coarse[i].found)
+    {
+      addPair(norm, coarse[i].grasp, coarse[i].result_n, line_data);
+    }
+  }
+}
+
+GraspPointGenerator::LineSample GraspPointGenerator::evaluateLineSample(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, 
+                                                                        const Eigen::Vector3d &direction_vector)
+{
+  LineSample sample;
+  sample.p = new_p;
+  int violated = precheckConstraints(norm, new_p, direction_vector);
+  if (violated >= 0)
+  {
+    constraint_prechecked_[violated]++;
+    return sample;
+  }
+
+  Eigen::Vector3d result_p;
+  sample.found = findPair(norm, new_p, result_p, sample.result_n);
+  if (sample.found)
+  {
+    sample.grasp = makeGraspData(norm, new_p, direction_vector, result_p);
+    if (findViolatedConstraint(config_.grasp_constraints, sample.grasp.hand_transform) < 0)
+    {
+      collisionCheck(sample.grasp);
+    }
+    sample.grasp.checked = true;
+  }
+  return sample;
+}
+
+void GraspPointGenerator::subdivideLine(const Eigen::Vector3d &norm, const LineSample &s1, const LineSample &s2, 
+                                        const Eigen::Vector3d &direction_vector, LineData & line_data)
+{
+  if ((s2.p - s1.p).norm() <= config_.point_distance) return;
+
+  bool same = (s1.found == s2.found);
+  if (same && s1.found)
+  {
+    same = (s1.grasp.available == s2.grasp.available) &&
+           std::fabs(s1.grasp.getDist() - s2.grasp.getDist()) <= config_.adaptive_width_tolerance;
+  }
+  if (same) return;
+
+  LineSample mid = evaluateLineSample(norm, (s1.p + s2.p) / 2, direction_vector);
+  subdivideLine(norm, s1, mid, direction_vector, line_data);
+  if (mid.found)
+  {
+    addPair(norm, mid.grasp, mid.result_n, line_data);
+  }
+  subdivideLine(norm, mid, s2, direction_vector, line_data);
+}
+
 void GraspPointGenerator::makePair(const Eigen::Vector3d &norm, Eigen::Vector3d new_p, Eigen::Vector3d direction_vector, LineData & line_data)
 {
-  static int h = 0;
-  PointT pcl_point_1;
+  int violated = precheckConstraints(norm, new_p, direction_vector);
+  if (violated >= 0)
+  {
+    constraint_prechecked_[violated]++;
+    return;
+  }
+
+  Eigen::Vector3d result_p, result_n;
+  if (findPair(norm, new_p, result_p, result_n))
+  {
+    addPair(norm, new_p, direction_vector, result_p, result_n, line_data);
+  }
+}
+
+/**
+ * @brief Constraint test of a contact point before its pair is searched
+ * 
+ * The grasp center lies within gripper_params[1] of new_p along -norm, and the 
+ * approach direction is direction_vector turned by one of the roll angles.
+ * 
+ * @return index of a constraint that no resulting grasp can satisfy, -1 if none
+ */
+int GraspPointGenerator::precheckConstraints(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, const Eigen::Vector3d &direction_vector) const
+{
+  if (config_.grasp_constraints.empty()) return -1;
+
+  std::vector<Eigen::Vector3d> approaches;
+  Eigen::Vector3d y = norm.cross(direction_vector);
+  for (double roll : config_.roll_angles)
+  {
+    approaches.push_back(direction_vector * std::cos(roll) + y * std::sin(roll));
+  }
+  return findViolatedConstraint(config_.grasp_constraints, new_p, new_p - norm * config_.gripper_params[1], approaches);
+}
+
+/**
+ * @brief Find the opposite contact point of new_p along -norm
+ * 
+ * Only reads the mesh, so it can be called from several threads.
+ * 
+ * @return false if no opposite triangle is hit
+ */
+bool GraspPointGenerator::findPair(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, Eigen::Vector3d &result_p, Eigen::Vector3d &result_n) const
+{
   for (auto & plane : planes_)
   {
     auto & n = plane.normal;
     if ((norm+n).norm() < 6e-1) // opposit dir tolerance
     {
-      Eigen::Vector3d result_p;
-      calcLinePlaneIntersection(plane, new_p, -norm, result_p);
+      if (!calcLinePlaneIntersection(plane, new_p, -norm, result_p))
+      {
+        continue;
+      }
 
       if (!pointInTriangle(result_p, plane))
       {
           continue;
       }
-      
-      eigen2PCL(new_p, norm, pcl_point_1, config_.point_color[0]*255,config_.point_color[1]*255,config_.point_color[2]*255);
-      candid_sample_cloud_->points.push_back(pcl_point_1);
-      candid_sample_cloud_->width++;
-
-      PointT pcl_point_2;
-      eigen2PCL(result_p, n, pcl_point_2, config_.point_color[0]*255,config_.point_color[1]*255,config_.point_color[2]*255);
-      candid_sample_cloud_->points.push_back(pcl_point_2);
-      candid_sample_cloud_->width++;
-
-      GraspData gd;
-      gd.hand_transform.linear().col(0) = direction_vector; // X
-      gd.hand_transform.linear().col(1) = norm.cross(direction_vector); // Y = Z cross X
-      gd.hand_transform.linear().col(2) = norm; // Z
-      gd.hand_transform.translation() = (new_p + result_p) / 2;
-      gd.points.push_back(new_p);
-      gd.points.push_back(result_p);
 
-      grasps_.push_back(gd);
-      line_data.sampled_grasp_data.push_back(gd);
-      // std::cout << "num: " << line_data.sampled_grasp_data.size() << std::endl;
+      result_n = n;
+      return true;
+    }
+  }
+  return false;
+}
 
-      break; 
-      
+GraspData GraspPointGenerator::makeGraspData(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, const Eigen::Vector3d &direction_vector,
+                                             const Eigen::Vector3d &result_p) const
+{
+  GraspData gd;
+  gd.hand_transform.linear().col(0) = direction_vector; // X
+  gd.hand_transform.linear().col(1) = norm.cross(direction_vector); // Y = Z cross X
+  gd.hand_transform.linear().col(2) = norm; // Z
+  gd.hand_transform.translation() = (new_p + result_p) / 2;
+  gd.points.push_back(new_p);
+  gd.points.push_back(result_p);
+  return gd;
+}
+
+void GraspPointGenerator::addPair(const Eigen::Vector3d &norm, const Eigen::Vector3d &new_p, const Eigen::Vector3d &direction_vector,
+                                  const Eigen::Vector3d &result_p, const Eigen::Vector3d &result_n, LineData & line_data)
+{
+  addPair(norm, makeGraspData(norm, new_p, direction_vector, result_p), result_n, line_data);
+}
+
+void GraspPointGenerator::addPair(const Eigen::Vector3d &norm, const GraspData &sampled_gd, const Eigen::Vector3d &result_n, LineData & line_data)
+{
+  GraspData gd = sampled_gd;
+  gd.normals = {norm, result_n};
+  const Eigen::Vector3d & new_p = gd.points[0];
+  const Eigen::Vector3d & result_p = gd.points[1];
+
+  PointT pcl_point_1;
+  eigen2PCL(new_p, norm, pcl_point_1, config_.point_color[0]*255,config_.point_color[1]*255,config_.point_color[2]*255);
+  candid_sample_cloud_->points.push_back(pcl_point_1);
+  candid_sample_cloud_->width++;
+
+  PointT pcl_point_2;
+  eigen2PCL(result_p, result_n, pcl_point_2, config_.point_color[0]*255,config_.point_color[1]*255,config_.point_color[2]*255);
+  candid_sample_cloud_->points.push_back(pcl_point_2);
+  candid_sample_cloud_->width++;
+
+  // the first angle is the one along the edge (see calcGraspable)
+  for (size_t i = 0; i < config_.roll_angles.size(); i++)
+  {
+    double roll = config_.roll_angles[i];
+    if (roll == 0.0)
+    {
+      grasps_.push_back(gd);
+    }
+    else
+    {
+      GraspData rolled = gd;
+      rolled.hand_transform.linear() = gd.hand_transform.linear() * Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitZ()).matrix();
+      rolled.available = false;
+      rolled.checked = false;
+      grasps_.push_back(rolled);
+    }
+    if (i == 0)
+    {
+      line_data.sampled_grasp_data.push_back(grasps_.back());
     }
   }
+  // std::cout << "num: " << line_data.sampled_grasp_data.size() << std::endl;
 }
 
 void GraspPointGenerator::sample()
@@ -453,71 +814,433 @@ void GraspPointGenerator::sample()
   {
     randomSample();
   }
+  else if (config_.point_generation_method == "poisson_disk_sample")
+  {
+    poissonDiskSample();
+  }
+}
+
+/**
+ * @brief Half-edges to sample from, the sides of each geometric edge next to each other
+ */
+std::vector<int> GraspPointGenerator::getEdgeSampleTasks() const
+{
+  std::vector<int> tasks;
+  for (const auto & edge : half_edge_mesh_.getEdges())
+  {
+    if (!isGraspableEdge(edge)) continue;
+
+    for (int h : edge.half_edge)
+    {
+      if (h < 0) continue;
+      if (!face_in_region_[HalfEdgeMesh::face(h)]) continue;
+
+      // edges inside a planar region are not graspable
+      if (!planes_[HalfEdgeMesh::face(h)].line_data[HalfEdgeMesh::lineIndex(h)].boundary) continue;
+
+      tasks.push_back(h);
+    }
+  }
+  return tasks;
 }
 
+/**
+ * @brief Sample along every geometric edge once, from the faces on both of its sides
+ */
 void GraspPointGenerator::analyticSample ()
 {
+  auto begin = std::chrono::steady_clock::now();
   for (auto & plane : planes_)
   {
-    samplePointsInTriangle(plane);
+    setupLineData(plane);
+  }
+
+  auto tasks = getEdgeSampleTasks();
+  for (int h : tasks)
+  {
+    samplePointsInEdge(planes_[HalfEdgeMesh::face(h)], HalfEdgeMesh::lineIndex(h));
+  }
+  size_t num_edges = tasks.size();
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << "[Sample] " << planes_.size() << " triangles";
+  if (config_.merge_coplanar_triangles)
+    std::cout << " -> " << regions_.size() << " planar regions";
+  std::cout << ", " << half_edge_mesh_.getEdges().size() << " edges"
+            << ", sampled edge sides: " << num_edges << " / " << planes_.size() * 3
+            << ", candidates: " << grasps_.size()
+            << ", time: " << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+}
+
+/**
+ * @brief Sampling and collision checking interleaved until anytime_budget_ms expires
+ * 
+ * 'geometry_analysis' takes the edges longest first; 'random_sample' runs batches 
+ * of convergence_batch_size samples (already area-weighted). All grasps classified 
+ * before the deadline are kept. 'auto' bv_type keeps OBBRSS, as timing the 
+ * types would eat into the budget.
+ */
+void GraspPointGenerator::anytimeGenerate()
+{
+  auto begin = std::chrono::steady_clock::now();
+  auto deadline = begin + std::chrono::microseconds(static_cast<long>(config_.anytime_budget_ms * 1e3));
+  anytime_report_ = AnytimeReport();
+
+  if (config_.point_generation_method == "geometry_analysis")
+  {
+    for (auto & plane : planes_)
+    {
+      setupLineData(plane);
+    }
+
+    auto edge_length = [this](int h) {
+      const auto & line = planes_[HalfEdgeMesh::face(h)].line_data[HalfEdgeMesh::lineIndex(h)];
+      return (line.points.first - line.points.second).norm();
+    };
+    auto tasks = getEdgeSampleTasks();
+    std::stable_sort(tasks.begin(), tasks.end(), [&edge_length](int a, int b) {
+      return edge_length(a) > edge_length(b);
+    });
+    for (int h : tasks)
+    {
+      anytime_report_.total += edge_length(h);
+    }
+
+    anytime_report_.unit = "m of edges";
+    for (int h : tasks)
+    {
+      if (std::chrono::steady_clock::now() >= deadline) break;
+
+      samplePointsInEdge(planes_[HalfEdgeMesh::face(h)], HalfEdgeMesh::lineIndex(h));
+      collisionCheck();
+      anytime_report_.covered += edge_length(h);
+    }
+  }
+  else if (config_.point_generation_method == "random_sample")
+  {
+    const long batch_size = std::max(1, config_.convergence_batch_size);
+    const long max_sample_num = config_.random_point_num;
+    long sample_num = 0;
+    anytime_report_.unit = "samples";
+    anytime_report_.total = max_sample_num;
+    while (sample_num < max_sample_num && std::chrono::steady_clock::now() < deadline)
+    {
+      long end = std::min(sample_num + batch_size, max_sample_num);
+      randomSample(sample_num, end);
+      collisionCheck();
+      sample_num = end;
+    }
+    anytime_report_.covered = sample_num;
+  }
+  else
+  {
+    std::cout << "[WARN] anytime mode does not support " << config_.point_generation_method 
+              << ", the budget is ignored" << std::endl;
+    sample();
+    collisionCheck();
+    return;
   }
+  auto end = std::chrono::steady_clock::now();
+
+  anytime_report_.elapsed_ms = std::chrono::duration<double>(end - begin).count() * 1e3;
+  std::cout << "[Anytime] budget: " << config_.anytime_budget_ms << " ms, elapsed: " << anytime_report_.elapsed_ms 
+            << " ms, covered: " << anytime_report_.covered << " / " << anytime_report_.total << " " << anytime_report_.unit
+            << ", candidates: " << grasps_.size() << ", feasible: " << grasp_cand_collision_free_.size() << std::endl;
 }
 
+/**
+ * @brief Area-weighted random sampling of random_point_num surface points
+ */
 void GraspPointGenerator::randomSample ()
 {
-  std::default_random_engine generator;
-  std::uniform_real_distribution<double> orientation_distribution(0.0,M_PI);
-  std::uniform_real_distribution<double> mesh_distribution(0.0,1.0);
+  randomSample(0, (config_.random_point_num + symmetry_.order() - 1) / symmetry_.order());
+}
 
-  double totalArea = 0;
-  std::vector<double> cumulativeAreas (planes_.size(), 0);
-  for (int i=0; i<planes_.size(); i++)
+/**
+ * @brief Face areas, zero outside the fundamental region of the symmetry
+ */
+std::vector<double> GraspPointGenerator::getFaceSampleWeights() const
+{
+  std::vector<double> areas (planes_.size());
+  for (size_t i=0; i<planes_.size(); i++)
   {
-    totalArea += planes_[i].area;
-    cumulativeAreas[i] = totalArea;
+    areas[i] = face_in_region_[i] ? planes_[i].area : 0.0;
+  }
+  return areas;
+}
 
+/**
+ * @brief Copy the feasible grasps by every element of the symmetry group
+ * 
+ * The mesh is invariant, so the copies need no collision check. A mirrored hand 
+ * frame is made right-handed again by flipping Y, which the gripper is symmetric about.
+ */
+void GraspPointGenerator::replicateSymmetricGrasps()
+{
+  const size_t num_original = grasp_cand_collision_free_.size();
+  for (const auto & transform : symmetry_.getTransforms())
+  {
+    for (size_t i = 0; i < num_original; i++)
+    {
+      GraspData grasp = grasp_cand_collision_free_[i];
+      grasp.hand_transform = transform * grasp.hand_transform;
+      if (transform.linear().determinant() < 0)
+      {
+        grasp.hand_transform.linear().col(1) *= -1;
+      }
+      for (auto & point : grasp.points)
+      {
+        point = transform * point;
+      }
+      for (auto & normal : grasp.normals)
+      {
+        normal = transform.linear() * normal;
+      }
+      int violated = findViolatedConstraint(config_.grasp_constraints, grasp.hand_transform);
+      if (violated >= 0)
+      {
+        constraint_rejected_[violated]++;
+        continue;
+      }
+
+      if(config_.remove_same_pose)
+      {
+        bool is_same = false;
+        for(auto & in_grasp : grasp_cand_collision_free_)
+        {
+          if( in_grasp.isSame(grasp, config_.same_dist, config_.same_angle) )
+          {
+            is_same = true;
+            break;
+          }
+        }
+        if( is_same )
+        {
+          continue;
+        }
+      }
+      grasp_cand_collision_free_.push_back(grasp);
+    }
+  }
+  std::cout << "[Symmetry] feasible grasps: " << num_original << " -> " << grasp_cand_collision_free_.size() << std::endl;
+}
+
+/**
+ * @brief Random sampling until the coverage of the feasible grasps converges
+ * 
+ * Batches are the consecutive sample index ranges of randomSample, so stopping 
+ * after n samples gives the same candidates as random_point_num = n.
+ */
+void GraspPointGenerator::convergentSample ()
+{
+  GraspCoverageEvaluator gce;
+  setupCoverageEvaluator(config_, planes_, {}, gce);
+  gce.getNumberOfBin();
+
+  const long batch_size = std::max(1, config_.convergence_batch_size);
+  const long max_sample_num = config_.random_point_num;
+  size_t num_added = 0;
+  double last_entropy = 0.0;
+  long sample_num = 0;
+  bool converged = false;
+
+  std::cout << "[Convergence] samples, feasible, pos_entropy, full_entropy, gain" << std::endl;
+  while (sample_num < max_sample_num && !converged)
+  {
+    long end = std::min(sample_num + batch_size, max_sample_num);
+    randomSample(sample_num, end);
+    if (sample_num == 0 && config_.bv_type == "auto")
+    {
+      selectBVType();
+    }
+    sample_num = end;
+    collisionCheck();
+
+    for (size_t i = num_added; i < grasp_cand_collision_free_.size(); i++)
+    {
+      const auto & grasp = grasp_cand_collision_free_[i];
+      gce.addGrasp(grasp.hand_transform.translation(), grasp.hand_transform.linear().col(0));
+    }
+    num_added = grasp_cand_collision_free_.size();
+
+    double full_entropy = gce.getRunningFullEntropy();
+    double gain = full_entropy - last_entropy;
+    last_entropy = full_entropy;
+    std::cout << "[Convergence] " << sample_num << ", " << num_added << ", " << gce.getRunningPosEntropy() 
+              << ", " << full_entropy << ", " << gain << std::endl;
+
+    // the first batch and batches before any feasible grasp do not count
+    converged = (sample_num > batch_size && num_added > 0 && gain < config_.convergence_entropy_threshold);
   }
-  candid_sample_cloud_->points.resize (config_.random_point_num);
-  candid_sample_cloud_->width = static_cast<std::uint32_t> (config_.random_point_num);
+
+  if (converged)
+    std::cout << "[Convergence] converged after " << sample_num << " samples" << std::endl;
+  else
+    std::cout << "[Convergence] not converged within " << max_sample_num << " samples" << std::endl;
+}
+
+/**
+ * @brief Area-weighted random sampling of the sample indices [begin, end), in parallel
+ * 
+ * Sample i draws its numbers from counterUniform(random_seed, i, stream), so the 
+ * candidates are identical for any number of threads. The triangle is chosen 
+ * with an alias table in O(1).
+ */
+void GraspPointGenerator::randomSample (long begin, long end)
+{
+  AliasTable face_table;
+  face_table.build(getFaceSampleWeights());
+  if (face_table.size() == 0)
+  {
+    std::cout << "[WARN] no triangle to sample (empty mesh or fundamental region)" << std::endl;
+    return;
+  }
+
+  struct RandomPair
+  {
+    bool found {false};
+    int violated {-1};
+    Eigen::Vector3d p, n, dir, result_p, result_n;
+  };
+  std::vector<RandomPair> pairs (std::max(0L, end - begin));
   candid_sample_cloud_->height = 1;
 
-  for (std::size_t i = 0; i < config_.random_point_num; i++)
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (long i = begin; i < end; i++)
   {
-    Eigen::Vector3d p;
-    Eigen::Vector3d n (0, 0, 0);
-    double r = mesh_distribution(generator) * totalArea;
-    double r1 = mesh_distribution(generator);
-    double r2 = mesh_distribution(generator);
-    randPSurface (planes_, cumulativeAreas, totalArea, p, n, r, r1, r2);
-    double theta = orientation_distribution(generator);
-    Eigen::Vector3d orth = getOrthogonalVector(n);
-    Eigen::Vector3d dir = orthogonalVector3d(n, orth, theta);
+    const std::uint64_t seed = config_.random_seed;
+    auto & pair = pairs[i - begin];
+
+    int el = face_table.sample(counterUniform(seed, i, 0), counterUniform(seed, i, 1));
+    randPTriangle (planes_[el], counterUniform(seed, i, 2), counterUniform(seed, i, 3), pair.p, pair.n);
+    double theta = counterUniform(seed, i, 4) * M_PI;
+    Eigen::Vector3d orth = getOrthogonalVector(pair.n);
+    pair.dir = orthogonalVector3d(pair.n, orth, theta);
 
-    if(dir.norm() > 1.01 || dir.norm() < 0.99)
+    if(pair.dir.norm() > 1.01 || pair.dir.norm() < 0.99 || pair.n.norm() > 1.01 || pair.n.norm() < 0.99)
     {
-      std::cout << "dir norm is " << dir.norm() << std::endl;
-      std::cout <<"[WARN] norm error dir: " << dir.transpose()<< std::endl;
-      std::cout <<"[WARN] n: " << n.transpose() << std::endl; 
+      #pragma omp critical
+      {
+        std::cout <<"[WARN] norm error dir: " << pair.dir.transpose()<< std::endl;
+        std::cout <<"[WARN] n: " << pair.n.transpose() << std::endl; 
+      }
     }
 
-    if(n.norm() > 1.01 || n.norm() < 0.99)
+    pair.violated = precheckConstraints(pair.n, pair.p, pair.dir);
+    if (pair.violated >= 0) continue;
+
+    pair.found = findPair(pair.n, pair.p, pair.result_p, pair.result_n);
+  }
+
+  // merge in the sample order
+  for (auto & pair : pairs)
+  {
+    if (pair.violated >= 0) constraint_prechecked_[pair.violated]++;
+    if (!pair.found) continue;
+
+    LineData tmp;
+    addPair(pair.n, pair.p, pair.dir, pair.result_p, pair.result_n, tmp);
+  }
+}
+
+/**
+ * @brief Blue-noise surface sampling by dart throwing
+ * 
+ * A point is rejected if an accepted point on a surface facing the same way lies 
+ * closer than same_dist * poisson_disk_radius_scale, so fewer candidates end up 
+ * being removed by remove_same_pose. Accepted points are looked up in a uniform 
+ * grid with the radius as cell size.
+ */
+void GraspPointGenerator::poissonDiskSample ()
+{
+  auto begin = std::chrono::steady_clock::now();
+
+  AliasTable face_table;
+  face_table.build(getFaceSampleWeights());
+  if (face_table.size() == 0)
+  {
+    std::cout << "[WARN] no triangle to sample (empty mesh or fundamental region)" << std::endl;
+    return;
+  }
+
+  const double radius = config_.same_dist * config_.poisson_disk_radius_scale;
+  const double inverse_cell_size = 1.0 / radius;
+  const std::uint64_t seed = config_.random_seed;
+  candid_sample_cloud_->height = 1;
+
+  std::vector<Eigen::Vector3d> points, normals;
+  std::unordered_map<SpatialHashKey, std::vector<int>, SpatialHashKeyHasher> grid;
+
+  int failures = 0;
+  std::uint64_t attempt = 0;
+  for (; failures < config_.poisson_disk_max_failures && (int)points.size() < config_.random_point_num; attempt++)
+  {
+    int el = face_table.sample(counterUniform(seed, attempt, 0), counterUniform(seed, attempt, 1));
+    Eigen::Vector3d p, n;
+    randPTriangle (planes_[el], counterUniform(seed, attempt, 2), counterUniform(seed, attempt, 3), p, n);
+
+    SpatialHashKey key (p, inverse_cell_size);
+    bool rejected = false;
+    for (int dx = -1; dx <= 1 && !rejected; dx++)
+      for (int dy = -1; dy <= 1 && !rejected; dy++)
+        for (int dz = -1; dz <= 1 && !rejected; dz++)
+        {
+          auto it = grid.find(key.offset(dx, dy, dz));
+          if (it == grid.end()) continue;
+          for (int j : it->second)
+          {
+            if (normals[j].dot(n) > 0 && (points[j] - p).norm() < radius)
+            {
+              rejected = true;
+              break;
+            }
+          }
+        }
+
+    if (rejected)
     {
-      std::cout << "n norm is " << n.norm() << endl;
-      std::cout <<"[WARN] norm error n: " << n.transpose()<< std::endl; 
+      failures++;
+      continue;
     }
+    failures = 0;
+    grid[key].push_back(points.size());
+    points.push_back(p);
+    normals.push_back(n);
+
+    double theta = counterUniform(seed, attempt, 4) * M_PI;
+    Eigen::Vector3d orth = getOrthogonalVector(n);
+    Eigen::Vector3d dir = orthogonalVector3d(n, orth, theta);
+
     LineData tmp;
     makePair(n, p, dir, tmp);
   }
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << "[Sample] poisson disk (r = " << radius << " m): " << points.size() << " points from "
+            << attempt << " attempts, candidates: " << grasps_.size()
+            << ", time: " << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
 }
 
 void GraspPointGenerator::collisionCheck()
 {
-  for(auto & grasp : grasps_)
+  // only the candidates added since the last call
+  for(size_t i = num_classified_; i < grasps_.size(); i++)
   {
-    collisionCheck(grasp);
+    auto & grasp = grasps_[i];
+    int violated = findViolatedConstraint(config_.grasp_constraints, grasp.hand_transform);
+    if (violated >= 0)
+    {
+      constraint_rejected_[violated]++;
+      grasp.available = false;
+      continue;
+    }
+    if (!grasp.checked)
+    {
+      collisionCheck(grasp);
+    }
 
     if (grasp.getDist() > config_.gripper_params[1] * 2) continue;
-    if(collision_check_.isFeasible(grasp.hand_transform, grasp.getDist()/2 + 0.001))
+    if(grasp.available)
     {
       // std::cout << "----------_$####??2" << std::endl;
       if(config_.remove_same_pose)
@@ -545,6 +1268,7 @@ void GraspPointGenerator::collisionCheck()
       grasp.available = false;
     }
   }
+  num_classified_ = grasps_.size();
 }
 
 void GraspPointGenerator::collisionCheck(GraspData &grasp)
@@ -556,13 +1280,120 @@ void GraspPointGenerator::collisionCheck(GraspData &grasp)
     return;
 
     // std::cout << "??-1" << std::endl;
-  if(collision_check_.isFeasible(grasp.hand_transform, grasp.getDist()/2 + 0.001))
+  if (config_.multi_width_evaluation)
+  {
+    double half_width = collision_check_->getMaxFeasibleWidth(grasp.hand_transform, getCandidateHalfWidths(grasp));
+    if (half_width >= 0.0)
+    {
+      grasp.width = half_width * 2;
+      grasp.available = true;
+    }
+    return;
+  }
+
+  if(collision_check_->isFeasible(grasp.hand_transform, grasp.getDist()/2 + 0.001))
   {
     // std::cout << "??-2" << std::endl;
     grasp.available = true;
   }
 }
 
+/**
+ * @brief Minimum distance to the object for every collision-free grasp
+ * 
+ * Distances are only resolved up to clearance_upper_bound, which keeps the 
+ * cost of a distance query close to that of the boolean check.
+ */
+void GraspPointGenerator::computeClearance()
+{
+  auto begin = std::chrono::steady_clock::now();
+  // getClearance only reads the models (fcl::distance works on its own copies for AABB/OBB)
+  const long num = grasp_cand_collision_free_.size();
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (long i = 0; i < num; i++)
+  {
+    auto & grasp = grasp_cand_collision_free_[i];
+    grasp.clearance = collision_check_->getClearance(grasp.hand_transform, config_.clearance_upper_bound);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << "[Clearance] " << grasp_cand_collision_free_.size() << " grasps, "
+            << std::chrono::duration<double>(end - begin).count() * 1e3 << " ms" << std::endl;
+}
+
+/**
+ * @brief Time every bounding volume type on a sample of the candidates and keep the fastest one
+ * 
+ * The estimated cost of a type is its build time plus the mean query time 
+ * multiplied by the number of candidates to be checked.
+ */
+void GraspPointGenerator::selectBVType()
+{
+  if (grasps_.empty())
+    return;
+
+  size_t sample_num = std::min(grasps_.size(), static_cast<size_t>(std::max(config_.bv_auto_sample_num, 1)));
+  size_t stride = grasps_.size() / sample_num;
+
+  double best_cost = std::numeric_limits<double>::infinity();
+  CollisionCheckBasePtr best_check;
+
+  for (const auto & bv_type : getBVTypeNames())
+  {
+    CollisionCheckBasePtr check = makeCollisionCheck(bv_type);
+    check->verbose_ = false;
+    check->setConfig(config_);
+
+    auto build_begin = std::chrono::steady_clock::now();
+    check->loadMesh(planes_);
+    auto build_end = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < sample_num; i++)
+    {
+      const auto & grasp = grasps_[i * stride];
+      check->isFeasible(grasp.hand_transform, 0.0);
+    }
+    auto query_end = std::chrono::steady_clock::now();
+
+    double build_time = std::chrono::duration<double>(build_end - build_begin).count();
+    double query_time = std::chrono::duration<double>(query_end - build_end).count() / sample_num;
+    double cost = build_time + query_time * grasps_.size();
+
+    std::cout << "[BV] " << bv_type << " build: " << build_time * 1e3 << " ms, query: "
+              << query_time * 1e6 << " us, estimated: " << cost * 1e3 << " ms" << std::endl;
+
+    if (cost < best_cost)
+    {
+      best_cost = cost;
+      best_check = check;
+    }
+  }
+
+  best_check->verbose_ = true;
+  collision_check_ = best_check;
+  std::cout << "[BV] selected: " << collision_check_->getBVName() << std::endl;
+}
+
+/**
+ * @brief Finger openings checked with multi_width_evaluation, widest first
+ * 
+ * The fully opened hand and the minimum fit (grasp.getDist()/2 + 0.001) plus each width margin.
+ */
+std::vector<double> GraspPointGenerator::getCandidateHalfWidths(GraspData &grasp)
+{
+  double open_half_width = collision_check_->getGripperModel().open_half_width;
+  std::vector<double> half_widths {open_half_width};
+  for (double margin : config_.width_margins)
+  {
+    double half_width = grasp.getDist()/2 + 0.001 + margin;
+    if (half_width < open_half_width)
+      half_widths.push_back(half_width);
+  }
+  std::sort(half_widths.begin(), half_widths.end(), std::greater<double>());
+  half_widths.erase(std::unique(half_widths.begin(), half_widths.end()), half_widths.end());
+  return half_widths;
+}
+
 void GraspPointGenerator::simplifyContGraspCandidates()
 {
   for(auto & g_a : continuous_grasp_pose_simplified_)
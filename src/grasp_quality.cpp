@@ -0,0 +1,83 @@
+#include "fgpg/grasp_quality.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+/// @brief row-wise dot products, one packet-wise product per coordinate column
+Eigen::ArrayXd rowDot(const Eigen::ArrayX3d & a, const Eigen::ArrayX3d & b)
+{
+  return a.col(0) * b.col(0) + a.col(1) * b.col(1) + a.col(2) * b.col(2);
+}
+}
+
+void ContactPairBatch::resize(Eigen::Index size)
+{
+  p0.resize(size, 3);
+  p1.resize(size, 3);
+  n0.resize(size, 3);
+  n1.resize(size, 3);
+}
+
+void scoreContactPairs(const ContactPairBatch & batch, double friction_coefficient, GraspQualityBatch & scores)
+{
+  const double cos_cone = 1.0 / std::sqrt(1.0 + friction_coefficient * friction_coefficient);
+
+  // closing direction from contact 0 to contact 1
+  Eigen::ArrayX3d d = batch.p1 - batch.p0;
+  Eigen::ArrayXd inv_length = rowDot(d, d).sqrt().max(1e-12).inverse();
+  for (int c = 0; c < 3; c++)
+  {
+    d.col(c) *= inv_length;
+  }
+
+  // finger 0 pushes along d into the surface (-n0), finger 1 along -d (-n1)
+  Eigen::ArrayXd cos_min = (-rowDot(d, batch.n0)).min(rowDot(d, batch.n1));
+  scores.cone_margin = ((cos_min - cos_cone) / (1.0 - cos_cone)).max(0.0).min(1.0);
+  scores.opposition = ((1.0 - rowDot(batch.n0, batch.n1)) / 2).max(0.0).min(1.0);
+  scores.quality = (cos_min >= cos_cone).select(scores.cone_margin * scores.opposition, 0.0);
+}
+
+void scoreGraspQuality(std::vector<GraspData> & grasps, double friction_coefficient)
+{
+  const long num_batches = (static_cast<long>(grasps.size()) + kGraspQualityBatchSize - 1) / kGraspQualityBatchSize;
+
+  #pragma omp parallel
+  {
+    ContactPairBatch batch;
+    GraspQualityBatch scores;
+
+    #pragma omp for schedule(static)
+    for (long b = 0; b < num_batches; b++)
+    {
+      const size_t begin = b * kGraspQualityBatchSize;
+      const size_t end = std::min(grasps.size(), begin + kGraspQualityBatchSize);
+      batch.resize(end - begin);
+      for (size_t i = begin; i < end; i++)
+      {
+        const GraspData & grasp = grasps[i];
+        const Eigen::Index r = i - begin;
+        if (grasp.points.size() < 2 || grasp.normals.size() < 2)
+        {
+          // scored as coincident contacts, which fails the cone test
+          batch.p0.row(r).setZero();
+          batch.p1.row(r).setZero();
+          batch.n0.row(r).setZero();
+          batch.n1.row(r).setZero();
+          continue;
+        }
+        batch.p0.row(r) = grasp.points[0].transpose().array();
+        batch.p1.row(r) = grasp.points[1].transpose().array();
+        batch.n0.row(r) = grasp.normals[0].transpose().array();
+        batch.n1.row(r) = grasp.normals[1].transpose().array();
+      }
+
+      scoreContactPairs(batch, friction_coefficient, scores);
+      for (size_t i = begin; i < end; i++)
+      {
+        grasps[i].quality = scores.quality(i - begin);
+      }
+    }
+  }
+}
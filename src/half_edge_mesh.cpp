@@ -0,0 +1,78 @@
+#include "fgpg/half_edge_mesh.h"
+#include "fgpg/vertex_welding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+void HalfEdgeMesh::build(const std::vector<TrianglePlaneData> &mesh, double weld_tolerance)
+{
+  std::vector<Eigen::Vector3i> indices;
+  weldVertices(mesh, weld_tolerance, vertices_, indices);
+
+  half_edges_.resize(mesh.size() * 3);
+  edges_.clear();
+
+  // undirected edge -> half-edges on it
+  std::map<std::pair<int, int>, std::vector<int> > edge_map;
+  for (size_t f = 0; f < mesh.size(); f++)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      int h = f * 3 + k;
+      half_edges_[h].vertex = indices[f](k);
+      half_edges_[h].next = f * 3 + (k + 1) % 3;
+      half_edges_[h].twin = -1;
+    }
+    if (isDegenerate(indices[f])) continue;
+
+    for (int k = 0; k < 3; k++)
+    {
+      int a = indices[f](k);
+      int b = indices[f]((k + 1) % 3);
+      edge_map[std::make_pair(std::min(a, b), std::max(a, b))].push_back(f * 3 + k);
+    }
+  }
+
+  for (const auto & entry : edge_map)
+  {
+    const auto & users = entry.second;
+    const Eigen::Vector3d & p0 = vertices_[entry.first.first];
+    const Eigen::Vector3d & p1 = vertices_[entry.first.second];
+
+    // a manifold edge is used twice in opposite directions
+    bool manifold = users.size() == 2 && 
+                    half_edges_[users[0]].vertex != half_edges_[users[1]].vertex;
+    if (!manifold)
+    {
+      for (int h : users)
+      {
+        MeshEdge edge;
+        edge.half_edge[0] = h;
+        edge.length = (p1 - p0).norm();
+        edges_.push_back(edge);
+      }
+      continue;
+    }
+
+    int h0 = users[0];
+    int h1 = users[1];
+    half_edges_[h0].twin = h1;
+    half_edges_[h1].twin = h0;
+
+    MeshEdge edge;
+    edge.half_edge[0] = h0;
+    edge.half_edge[1] = h1;
+    edge.length = (p1 - p0).norm();
+
+    const Eigen::Vector3d & n0 = mesh[face(h0)].normal;
+    const Eigen::Vector3d & n1 = mesh[face(h1)].normal;
+    edge.dihedral_angle = std::acos(std::max(-1.0, std::min(1.0, n0.dot(n1))));
+
+    // the opposite corner of the second face lies above the first face in a valley
+    const Eigen::Vector3d & opposite = vertices_[half_edges_[half_edges_[half_edges_[h1].next].next].vertex];
+    edge.concave = n0.dot(opposite - p0) > 0.0;
+
+    edges_.push_back(edge);
+  }
+}
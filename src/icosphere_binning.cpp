@@ -0,0 +1,83 @@
+#include "fgpg/icosphere_binning.h"
+
+#include <algorithm>
+#include <cmath>
+
+void IcosphereBinning::build(int subdivision)
+{
+  const double t = (1.0 + std::sqrt(5.0)) / 2.0;
+  std::vector<Eigen::Vector3d> v = {
+    {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+    {0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+    {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}};
+  for (auto & p : v) p.normalize();
+
+  const int faces[20][3] = {
+    {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+    {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+    {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+    {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1}};
+
+  levels_.assign(1, std::vector<Face>());
+  for (const auto & f : faces)
+  {
+    levels_[0].push_back(Face{v[f[0]], v[f[1]], v[f[2]]});
+  }
+
+  for (int s = 0; s < subdivision; s++)
+  {
+    std::vector<Face> children;
+    children.reserve(levels_.back().size() * 4);
+    for (const auto & f : levels_.back())
+    {
+      Eigen::Vector3d ab = (f.a + f.b).normalized();
+      Eigen::Vector3d bc = (f.b + f.c).normalized();
+      Eigen::Vector3d ca = (f.c + f.a).normalized();
+      children.push_back(Face{f.a, ab, ca});
+      children.push_back(Face{ab, f.b, bc});
+      children.push_back(Face{ca, bc, f.c});
+      children.push_back(Face{ab, bc, ca});
+    }
+    levels_.push_back(children);
+  }
+}
+
+double IcosphereBinning::inside(const Face &face, const Eigen::Vector3d &direction)
+{
+  return std::min(std::min(direction.dot(face.a.cross(face.b)), direction.dot(face.b.cross(face.c))),
+                  direction.dot(face.c.cross(face.a)));
+}
+
+int IcosphereBinning::getCell(const Eigen::Vector3d &direction) const
+{
+  // the face the direction is deepest in, so that a direction on an edge 
+  // still gets exactly one cell
+  int cell = 0;
+  double best = inside(levels_[0][0], direction);
+  for (int i = 1; i < 20; i++)
+  {
+    double value = inside(levels_[0][i], direction);
+    if (value > best)
+    {
+      best = value;
+      cell = i;
+    }
+  }
+
+  for (size_t s = 1; s < levels_.size(); s++)
+  {
+    int parent = cell;
+    cell = parent * 4;
+    best = inside(levels_[s][cell], direction);
+    for (int c = 1; c < 4; c++)
+    {
+      double value = inside(levels_[s][parent * 4 + c], direction);
+      if (value > best)
+      {
+        best = value;
+        cell = parent * 4 + c;
+      }
+    }
+  }
+  return cell;
+}
@@ -38,6 +38,8 @@
 
 #include "fgpg/mesh_sampling.h"
 
+#include <algorithm>
+
 
 double
 uniform_deviate (int seed)
@@ -76,13 +78,95 @@ double r, double r1, double r2)
   std::vector<double>::iterator low = std::lower_bound (cumulativeAreas.begin (), cumulativeAreas.end (), r);
   int el = int (low - cumulativeAreas.begin ());
 
+  randPTriangle (planes[el], r1, r2, p, n);
+}
+
+void
+randPTriangle (const TrianglePlaneData& plane, double r1, double r2,
+               Eigen::Vector3d& p, Eigen::Vector3d& n)
+{
   // OBJ: Vertices are stored in a counter-clockwise order by default
-  Eigen::Vector3d v1 = planes[el].points[0] - planes[el].points[2];
-  Eigen::Vector3d v2 = planes[el].points[1] - planes[el].points[2];
+  Eigen::Vector3d v1 = plane.points[0] - plane.points[2];
+  Eigen::Vector3d v2 = plane.points[1] - plane.points[2];
   n = v1.cross (v2);
   n.normalize ();
 
-  randomPointTriangle (float (planes[el].points[0][0]), float (planes[el].points[0][1]), float (planes[el].points[0][2]),
-                       float (planes[el].points[1][0]), float (planes[el].points[1][1]), float (planes[el].points[1][2]),
-                       float (planes[el].points[2][0]), float (planes[el].points[2][1]), float (planes[el].points[2][2]), r1, r2, p);
+  randomPointTriangle (float (plane.points[0][0]), float (plane.points[0][1]), float (plane.points[0][2]),
+                       float (plane.points[1][0]), float (plane.points[1][1]), float (plane.points[1][2]),
+                       float (plane.points[2][0]), float (plane.points[2][1]), float (plane.points[2][2]), r1, r2, p);
+}
+
+static inline std::uint64_t
+splitMix64 (std::uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+double
+counterUniform (std::uint64_t seed, std::uint64_t index, std::uint32_t stream)
+{
+  const std::uint64_t golden_gamma = 0x9e3779b97f4a7c15ULL;
+  std::uint64_t z = splitMix64 (seed + golden_gamma * (index + 1));
+  z = splitMix64 (z + golden_gamma * (static_cast<std::uint64_t> (stream) + 1));
+  // 53 bits mantissa
+  return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void
+AliasTable::build (const std::vector<double>& weights)
+{
+  const size_t n = weights.size ();
+  double total = 0;
+  for (double w : weights)
+    total += w;
+  if (n == 0 || total <= 0)
+  {
+    // nothing can be sampled
+    prob_.clear ();
+    alias_.clear ();
+    return;
+  }
+
+  prob_.assign (n, 1.0);
+  alias_.resize (n);
+  for (size_t i = 0; i < n; i++)
+    alias_[i] = i;
+
+  std::vector<double> scaled (n);
+  std::vector<int> small, large;
+  for (size_t i = 0; i < n; i++)
+  {
+    scaled[i] = weights[i] * n / total;
+    if (scaled[i] < 1.0)
+      small.push_back (i);
+    else
+      large.push_back (i);
+  }
+
+  while (!small.empty () && !large.empty ())
+  {
+    int s = small.back (); small.pop_back ();
+    int l = large.back (); large.pop_back ();
+
+    prob_[s] = scaled[s];
+    alias_[s] = l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+
+    if (scaled[l] < 1.0)
+      small.push_back (l);
+    else
+      large.push_back (l);
+  }
+  // the rest are 1 up to rounding errors
+}
+
+int
+AliasTable::sample (double u1, double u2) const
+{
+  if (prob_.empty ())
+    return -1;
+  size_t i = std::min (static_cast<size_t> (u1 * prob_.size ()), prob_.size () - 1);
+  return (u2 < prob_[i]) ? static_cast<int> (i) : alias_[i];
 }
@@ -0,0 +1,59 @@
+#include "fgpg/planar_region.h"
+
+#include <cmath>
+#include <queue>
+
+std::vector<PlanarRegion> buildPlanarRegions(std::vector<TrianglePlaneData> &mesh, 
+                                             const HalfEdgeMesh &half_edge_mesh, double angle_tolerance)
+{
+  const double cos_tolerance = std::cos(angle_tolerance);
+  std::vector<PlanarRegion> regions;
+  for (auto & triangle : mesh)
+  {
+    triangle.region_id = -1;
+  }
+
+  for (size_t seed = 0; seed < mesh.size(); seed++)
+  {
+    if (mesh[seed].region_id >= 0) continue;
+
+    PlanarRegion region;
+    region.normal = mesh[seed].normal;
+    const int region_id = regions.size();
+
+    std::queue<int> open;
+    open.push(seed);
+    mesh[seed].region_id = region_id;
+    while (!open.empty())
+    {
+      int t = open.front();
+      open.pop();
+      region.triangles.push_back(t);
+      region.area += mesh[t].area;
+
+      for (int k = 0; k < 3; k++)
+      {
+        int nb = half_edge_mesh.neighbour(t * 3 + k);
+        if (nb < 0 || mesh[nb].region_id >= 0) continue;
+        if (mesh[nb].normal.dot(region.normal) < cos_tolerance) continue;
+
+        mesh[nb].region_id = region_id;
+        open.push(nb);
+      }
+    }
+
+    for (int t : region.triangles)
+    {
+      for (int k = 0; k < 3; k++)
+      {
+        int nb = half_edge_mesh.neighbour(t * 3 + k);
+        auto & line = mesh[t].line_data[HalfEdgeMesh::lineIndex(t * 3 + k)];
+        line.boundary = (nb < 0 || mesh[nb].region_id != region_id);
+        if (line.boundary) region.num_boundary_edges++;
+      }
+    }
+    regions.push_back(region);
+  }
+
+  return regions;
+}
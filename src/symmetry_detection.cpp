@@ -0,0 +1,132 @@
+#include "fgpg/symmetry_detection.h"
+#include "fgpg/spatial_hash.h"
+
+#include <cmath>
+#include <unordered_map>
+
+std::vector<Eigen::Isometry3d> SymmetryGroup::getTransforms() const
+{
+  std::vector<Eigen::Isometry3d> transforms;
+  Eigen::Isometry3d to_center;
+  to_center.setIdentity();
+  to_center.translation() = center;
+  if (mirror)
+  {
+    Eigen::Isometry3d reflection;
+    reflection.setIdentity();
+    reflection.linear() -= 2 * axis * axis.transpose();
+    transforms.push_back(to_center * reflection * to_center.inverse());
+    return transforms;
+  }
+
+  for (int i = 1; i < fold; i++)
+  {
+    Eigen::Isometry3d rotation;
+    rotation.setIdentity();
+    rotation.linear() = Eigen::AngleAxisd(2 * M_PI * i / fold, axis).matrix();
+    transforms.push_back(to_center * rotation * to_center.inverse());
+  }
+  return transforms;
+}
+
+bool SymmetryGroup::inFundamentalRegion(const Eigen::Vector3d &point) const
+{
+  Eigen::Vector3d d = point - center;
+  if (mirror)
+  {
+    return d.dot(axis) >= 0;
+  }
+  if (fold <= 1) return true;
+
+  double angle = std::atan2(axis.cross(ref_direction).dot(d), ref_direction.dot(d));
+  if (angle < 0) angle += 2 * M_PI;
+  return angle < 2 * M_PI / fold;
+}
+
+namespace
+{
+
+typedef std::unordered_map<SpatialHashKey, std::vector<int>, SpatialHashKeyHasher> VertexGrid;
+
+bool isInvariant(const std::vector<Eigen::Vector3d> &vertices, const VertexGrid &grid, 
+                 const Eigen::Isometry3d &transform, double tolerance)
+{
+  const double inverse_cell_size = 1.0 / tolerance;
+  for (const auto & v : vertices)
+  {
+    Eigen::Vector3d p = transform * v;
+    SpatialHashKey key (p, inverse_cell_size);
+    bool found = false;
+    for (int dx = -1; dx <= 1 && !found; dx++)
+      for (int dy = -1; dy <= 1 && !found; dy++)
+        for (int dz = -1; dz <= 1 && !found; dz++)
+        {
+          auto it = grid.find(key.offset(dx, dy, dz));
+          if (it == grid.end()) continue;
+          for (int j : it->second)
+          {
+            if ((vertices[j] - p).norm() <= tolerance)
+            {
+              found = true;
+              break;
+            }
+          }
+        }
+    if (!found) return false;
+  }
+  return true;
+}
+
+}
+
+SymmetryGroup detectSymmetry(const std::vector<Eigen::Vector3d> &vertices, int max_fold, double tolerance)
+{
+  SymmetryGroup group;
+  if (vertices.empty()) return group;
+
+  Eigen::Vector3d centroid = Eigen::Vector3d::Zero();
+  for (const auto & v : vertices) centroid += v;
+  centroid /= vertices.size();
+
+  Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+  for (const auto & v : vertices) covariance += (v - centroid) * (v - centroid).transpose();
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver (covariance);
+
+  VertexGrid grid;
+  for (size_t i = 0; i < vertices.size(); i++)
+  {
+    grid[SpatialHashKey(vertices[i], 1.0 / tolerance)].push_back(i);
+  }
+
+  group.center = centroid;
+  for (int k = 0; k < 3; k++)
+  {
+    SymmetryGroup candidate = group;
+    candidate.axis = solver.eigenvectors().col(k).normalized();
+    candidate.ref_direction = solver.eigenvectors().col((k + 1) % 3).normalized();
+
+    for (int n = max_fold; n > std::max(1, group.fold); n--)
+    {
+      candidate.fold = n;
+      if (isInvariant(vertices, grid, candidate.getTransforms()[0], tolerance))
+      {
+        group = candidate;
+        break;
+      }
+    }
+  }
+  if (group.fold > 1) return group;
+
+  for (int k = 0; k < 3; k++)
+  {
+    SymmetryGroup candidate = group;
+    candidate.axis = solver.eigenvectors().col(k).normalized();
+    candidate.ref_direction = solver.eigenvectors().col((k + 1) % 3).normalized();
+    candidate.mirror = true;
+    if (isInvariant(vertices, grid, candidate.getTransforms()[0], tolerance))
+    {
+      return candidate;
+    }
+  }
+  return group;
+}
@@ -0,0 +1,99 @@
+#include "fgpg/triangle_bvh.h"
+#include "fgpg/geometrics.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+const int kLeafSize = 4;
+}
+
+void TriangleBVH::build(const std::vector<TrianglePlaneData> &planes)
+{
+  planes_ = &planes;
+  nodes_.clear();
+  indices_.resize(planes.size());
+  std::vector<Eigen::Vector3d> centroids (planes.size());
+  for (size_t i = 0; i < planes.size(); i++)
+  {
+    indices_[i] = i;
+    centroids[i] = (planes[i].points[0] + planes[i].points[1] + planes[i].points[2]) / 3;
+  }
+  if (planes.empty()) return;
+
+  nodes_.reserve(2 * planes.size() / kLeafSize + 1);
+  buildNode(0, planes.size(), centroids);
+}
+
+int TriangleBVH::buildNode(int begin, int end, const std::vector<Eigen::Vector3d> &centroids)
+{
+  int id = nodes_.size();
+  nodes_.push_back(Node());
+
+  Eigen::AlignedBox3d box, centroid_box;
+  for (int i = begin; i < end; i++)
+  {
+    for (const auto & p : (*planes_)[indices_[i]].points) box.extend(p);
+    centroid_box.extend(centroids[indices_[i]]);
+  }
+  // slack for the planarity tolerance of pointInTriangle
+  box.min().array() -= 1e-6;
+  box.max().array() += 1e-6;
+  nodes_[id].box = box;
+
+  // median split along the longest axis of the centroids (depth stays below log2(n) + 1)
+  if (end - begin <= kLeafSize)
+  {
+    nodes_[id].begin = begin;
+    nodes_[id].end = end;
+    return id;
+  }
+  int axis;
+  centroid_box.sizes().maxCoeff(&axis);
+  int mid = (begin + end) / 2;
+  std::nth_element(indices_.begin() + begin, indices_.begin() + mid, indices_.begin() + end,
+                   [&centroids, axis](int a, int b) { return centroids[a](axis) < centroids[b](axis); });
+
+  int left = buildNode(begin, mid, centroids);
+  int right = buildNode(mid, end, centroids);
+  nodes_[id].left = left;
+  nodes_[id].right = right;
+  return id;
+}
+
+bool TriangleBVH::hitBox(const Eigen::AlignedBox3d &box, const Eigen::Vector3d &origin, const Eigen::Vector3d &inverse_direction)
+{
+  double t_min = 0.0;
+  double t_max = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < 3; i++)
+  {
+    if (std::isinf(inverse_direction(i)))
+    {
+      if (origin(i) < box.min()(i) || origin(i) > box.max()(i)) return false;
+      continue;
+    }
+    double t0 = (box.min()(i) - origin(i)) * inverse_direction(i);
+    double t1 = (box.max()(i) - origin(i)) * inverse_direction(i);
+    if (t0 > t1) std::swap(t0, t1);
+    t_min = std::max(t_min, t0);
+    t_max = std::min(t_max, t1);
+    if (t_min > t_max) return false;
+  }
+  return true;
+}
+
+double TriangleBVH::getPalmDistance(const Eigen::Vector3d &origin, const Eigen::Vector3d &direction) const
+{
+  double min_distance = std::numeric_limits<double>::infinity();
+  raycast(origin, direction, [&](int index) {
+    const auto & plane = (*planes_)[index];
+    Eigen::Vector3d p;
+    if (!calcLinePlaneIntersection(plane, origin, direction, p)) return;
+    if (!pointInTriangle(p, plane)) return;
+
+    double dist = (origin - plane.points[0]).dot(plane.normal);
+    if (dist >= 0.0 && dist < min_distance) min_distance = dist;
+  });
+  return min_distance;
+}
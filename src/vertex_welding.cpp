@@ -0,0 +1,64 @@
+#include "fgpg/vertex_welding.h"
+#include "fgpg/spatial_hash.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+int weldVertices(const std::vector<TrianglePlaneData> &mesh, double tolerance,
+                 std::vector<Eigen::Vector3d> &vertices, std::vector<Eigen::Vector3i> &indices)
+{
+  tolerance = std::max(tolerance, 1e-12);
+  const double inverse_cell_size = 1.0 / tolerance;
+  const double squared_tolerance = tolerance * tolerance;
+
+  std::unordered_map<SpatialHashKey, std::vector<int>, SpatialHashKeyHasher> grid;
+  grid.reserve(mesh.size() * 2);
+
+  vertices.clear();
+  vertices.reserve(mesh.size() / 2 + 3);
+  indices.resize(mesh.size());
+
+  int num_degenerate = 0;
+  for (size_t t = 0; t < mesh.size(); t++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      const Eigen::Vector3d & point = mesh[t].points[c];
+      SpatialHashKey key(point, inverse_cell_size);
+
+      int found = -1;
+      for (int dx = -1; dx <= 1 && found < 0; dx++)
+      {
+        for (int dy = -1; dy <= 1 && found < 0; dy++)
+        {
+          for (int dz = -1; dz <= 1 && found < 0; dz++)
+          {
+            auto it = grid.find(key.offset(dx, dy, dz));
+            if (it == grid.end()) continue;
+
+            for (int v : it->second)
+            {
+              if ((vertices[v] - point).squaredNorm() <= squared_tolerance)
+              {
+                found = v;
+                break;
+              }
+            }
+          }
+        }
+      }
+
+      if (found < 0)
+      {
+        found = vertices.size();
+        vertices.push_back(point);
+        grid[key].push_back(found);
+      }
+      indices[t](c) = found;
+    }
+
+    if (isDegenerate(indices[t])) num_degenerate++;
+  }
+
+  return num_degenerate;
+}